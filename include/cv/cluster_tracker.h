@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV_CLUSTER_TRACKER_H
+#define SHIMETA_SDK_ALGORITHM_CV_CLUSTER_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+/// @brief 簇跟踪结果
+struct ClusterTrack {
+    uint32_t id;
+    float x;                      // 质心（像素），外推到输出时刻
+    float y;
+    float vx;                     // 像素/秒
+    float vy;
+    float size;                   // 主轴方向的标准差（像素）
+    uint32_t events;              // 累计分配的事件数
+    Metavision::timestamp tFirst; // 簇创建时刻
+    Metavision::timestamp tLast;  // 最近一次分配事件的时刻
+};
+
+/// @brief Event-driven multi-object cluster tracker.
+/// @details 每个事件通过空间哈希网格（单元边长等于关联半径）只检查周围 3x3 个单元中的簇，
+/// 分配给质心距离最近且在关联半径内的簇，没有候选时新建簇，因此每事件的开销与簇总数无关。
+/// 质心与二阶矩按指数滑动平均增量更新，速度由固定时间窗口内的质心位移平滑估计。
+/// 事件同时落在两个质心距离小于 mergeDistance 的簇内时合并两者；簇的主轴标准差超过
+/// splitRatio * radius 时沿主轴一分为二；簇按最近更新时刻排成链表，超过 maxIdle 未更新的簇从表头移除。
+/// 以上操作每事件均摊 O(1)。累计事件数达到 minEvents 的簇才作为跟踪结果输出。
+class ClusterTracker {
+public:
+    using TrackCallback = std::function<void(Metavision::timestamp, const std::vector<ClusterTrack> &)>;
+
+    static constexpr uint32_t kNoCluster = 0;
+
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param radius 事件与簇质心的关联半径（像素），应大于被跟踪目标的尺寸
+    /// @param maxIdle 簇的最长空闲时间（微秒），超时后移除
+    /// @param minEvents 簇作为跟踪结果输出所需的最少事件数
+    /// @param positionGain 质心与二阶矩的平滑系数
+    /// @param velocityWindow 速度估计的时间窗口（微秒）
+    /// @param velocityGain 速度的平滑系数
+    /// @param mergeDistance 合并两个簇的质心距离（像素）
+    /// @param splitRatio 分裂阈值，主轴标准差与 radius 之比
+    /// @param maxClusters 同时存在的最大簇数，已满时移除最久未更新的簇
+    ClusterTracker(
+        int width,
+        int height,
+        float radius = 10.0f,
+        Metavision::timestamp maxIdle = 20000,
+        uint32_t minEvents = 20,
+        float positionGain = 0.05f,
+        Metavision::timestamp velocityWindow = 5000,
+        float velocityGain = 0.3f,
+        float mergeDistance = 3.0f,
+        float splitRatio = 0.5f,
+        size_t maxClusters = 1024
+    );
+
+    /// @brief 清空全部簇
+    void initialize();
+
+    /// @brief 启用周期性的跟踪输出
+    /// @param period 输出周期（微秒），事件时间跨过周期边界时调用 callback
+    /// @param callback 接收输出时刻与该时刻的跟踪结果
+    void setTrackOutput(Metavision::timestamp period, TrackCallback callback);
+
+    /// @brief 把单个事件分配给簇
+    /// @param event 输入事件，时间戳需单调不减
+    /// @return 分配到的簇 id
+    uint32_t assign(const Metavision::EventCD &event);
+
+    /// @brief 批量处理事件
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 批量处理事件
+    /// @param labels 清空后按输入顺序写入每个事件所属的簇 id
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<uint32_t> &labels);
+
+    /// @brief 批量处理事件
+    /// @param events 输入事件向量
+    void process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 获取指定时刻的跟踪结果，按 id 升序
+    /// @param t 外推质心所用的时刻
+    /// @param out 清空后写入跟踪结果
+    void snapshot(Metavision::timestamp t, std::vector<ClusterTrack> &out) const;
+
+    /// @brief 最近一次周期输出的跟踪结果
+    inline const std::vector<ClusterTrack> &tracks() const noexcept {
+        return mTracks;
+    }
+
+    /// @brief 当前存在的簇数（含未达到 minEvents 的簇）
+    inline size_t activeClusters() const noexcept {
+        return mActive;
+    }
+
+private:
+    struct Cluster {
+        uint32_t id;
+        float x;
+        float y;
+        float sxx;                     // 相对质心的二阶矩
+        float sxy;
+        float syy;
+        float vx;
+        float vy;
+        float anchorX;                 // 速度窗口起点的质心
+        float anchorY;
+        Metavision::timestamp tAnchor;
+        Metavision::timestamp tFirst;
+        Metavision::timestamp tLast;
+        uint32_t events;
+        bool hasVelocity;
+        int32_t cell;                  // 所在网格单元
+        int32_t cellPrev;              // 网格单元内的双向链表
+        int32_t cellNext;
+        int32_t agePrev;               // 按最近更新时刻排序的双向链表
+        int32_t ageNext;
+    };
+
+    int mWidth;
+    int mHeight;
+    float mRadius;
+    Metavision::timestamp mMaxIdle;
+    uint32_t mMinEvents;
+    float mPositionGain;
+    Metavision::timestamp mVelocityWindow;
+    float mVelocityGain;
+    float mMergeDistance;
+    float mSplitVariance;
+    size_t mMaxClusters;
+
+    int mCellSize;
+    int mGridWidth;
+    int mGridHeight;
+    std::vector<int32_t> mCellHead;
+    std::vector<Cluster> mClusters;
+    std::vector<int32_t> mFree;
+    int32_t mAgeHead;
+    int32_t mAgeTail;
+    size_t mActive;
+    uint32_t mNextId;
+
+    Metavision::timestamp mPeriod;
+    Metavision::timestamp mOutputEnd;
+    TrackCallback mCallback;
+    std::vector<ClusterTrack> mTracks;
+
+    /// @brief 新建簇，簇数已满时先移除最久未更新的簇
+    int32_t create(float x, float y, Metavision::timestamp t);
+
+    /// @brief 移除簇并回收其槽位
+    void remove(int32_t index);
+
+    /// @brief 按质心位置挂入网格单元
+    void link(int32_t index);
+
+    /// @brief 从网格单元中摘除
+    void unlink(int32_t index);
+
+    /// @brief 移到按更新时刻排序的链表尾部
+    void touch(int32_t index);
+
+    /// @brief 用事件增量更新质心、二阶矩与速度
+    void update(int32_t index, const Metavision::EventCD &event);
+
+    /// @brief 把 drop 合并进 keep
+    void merge(int32_t keep, int32_t drop);
+
+    /// @brief 主轴方向过宽时沿主轴一分为二
+    void trySplit(int32_t index);
+
+    /// @brief 移除在 t 时刻已超时的簇
+    void expire(Metavision::timestamp t);
+};
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV_CLUSTER_TRACKER_H
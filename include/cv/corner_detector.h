@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV_CORNER_DETECTOR_H
+#define SHIMETA_SDK_ALGORITHM_CV_CORNER_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/event_partitioner.h"
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+/// @brief Incremental event-based corner detector on the SAE.
+/// @details 为每个极性维护 SAE（每像素最近时间戳），每个事件先更新 SAE，再在固定大小的邻域上做常数时间的角点判定：
+/// - FAST：eFAST 判据，半径 3（16 像素）与半径 4（20 像素）两个圆上各存在一段连续弧，其时间戳都新于圆上其余像素，
+///   弧长分别在 [3, 6] 和 [4, 8] 之间；
+/// - HARRIS：eHarris 判据，取 9x9 邻域中最新的 harrisQueueSize 个像素构成二值图，用 Sobel 梯度计算 Harris 响应。
+/// 可选地用任意去噪器作为前置门控，被门控剔除的事件不更新 SAE；批量处理时门控按输入顺序串行执行。
+/// threads 大于 1 时启用多行带模式：角点判定按行带分两轮并行，结果与线程数无关，
+/// 但行带边界处的事件在同一批次内看不到相邻行带中的较早事件，批次时长应保持在毫秒级。
+/// 距离传感器边界不足 4 像素的事件只更新 SAE。
+class CornerDetector {
+public:
+    enum class Method { FAST, HARRIS };
+
+    using Gate = std::function<bool(const Metavision::EventCD &)>;
+
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param method 角点判据
+    /// @param harrisThreshold 归一化 Harris 响应阈值，单位阶跃边缘的梯度为 1（仅 HARRIS）
+    /// @param harrisQueueSize 构成二值图的最新像素数（仅 HARRIS）
+    /// @param tileRows 并行行带高度
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程（默认，结果与逐事件 evaluate() 一致）
+    CornerDetector(
+        int width,
+        int height,
+        Method method = Method::FAST,
+        double harrisThreshold = 0.025,
+        int harrisQueueSize = 25,
+        int tileRows = 32,
+        size_t threads = 1
+    );
+
+    /// @brief 清空 SAE
+    void initialize();
+
+    /// @brief 设置前置门控，例如 [&](const auto &e) { return denoiser.retain(e); }；传入空函数取消门控
+    void setGate(Gate gate);
+
+    /// @brief 处理单个事件
+    /// @param event 输入事件
+    /// @return true 为角点事件
+    bool evaluate(const Metavision::EventCD &event);
+
+    /// @brief 处理单个事件
+    inline bool retain(const Metavision::EventCD &event) {
+        return evaluate(event);
+    }
+
+    /// @brief 批量检测角点
+    /// @param out 清空后按输入顺序写入角点事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
+    /// @brief 批量检测角点
+    /// @param events 输入事件向量
+    /// @return 角点事件
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+private:
+    int mWidth;
+    int mHeight;
+    Method mMethod;
+    double mHarrisThreshold;
+    int mHarrisQueueSize;
+
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    Utils::EventPartitioner mPartitioner;
+    Gate mGate;
+    std::vector<Metavision::timestamp> mSae; // [2][H][W]
+    std::vector<Metavision::EventCD> mGated;
+    std::vector<uint8_t> mIsCorner;
+
+    /// @brief 更新 SAE 并判定角点，不经过门控
+    bool detect(const Metavision::EventCD &event);
+
+    /// @brief eFAST 判据
+    bool isFastCorner(const Metavision::timestamp *sae, int x, int y, Metavision::timestamp t) const;
+
+    /// @brief eHarris 判据
+    bool isHarrisCorner(const Metavision::timestamp *sae, int x, int y, Metavision::timestamp t) const;
+};
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV_CORNER_DETECTOR_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV_EVENT_REPRESENTATION_H
+#define SHIMETA_SDK_ALGORITHM_CV_EVENT_REPRESENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/event_partitioner.h"
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+/// @brief Event-to-tensor conversion engine.
+/// @details 将事件区间转换为网络输入常用的稠密表示：计数图、体素网格、事件脉冲张量（EST）和指数时间面。
+/// 所有输出写入调用方提供的 float 缓冲区（行优先，布局见各函数说明），accumulate 为 true 时不清零，
+/// 因此可以把一个时间窗口分多批增量累积。事件按行带划分后在线程池上并行累积，结果与单线程完全一致；
+/// 逐像素的稠密循环写成连续访存形式，便于编译器向量化。
+/// 事件坐标须在传感器范围内。
+class EventRepresentation {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程
+    EventRepresentation(int width, int height, size_t threads = 0);
+
+    /// @brief 计数图元素个数 2*H*W
+    inline size_t countImageSize() const noexcept {
+        return 2 * mPixels;
+    }
+
+    /// @brief 体素网格元素个数 bins*H*W
+    inline size_t voxelGridSize(int bins) const noexcept {
+        return static_cast<size_t>(bins) * mPixels;
+    }
+
+    /// @brief 事件脉冲张量元素个数 2*bins*H*W
+    inline size_t eventSpikeTensorSize(int bins) const noexcept {
+        return 2 * static_cast<size_t>(bins) * mPixels;
+    }
+
+    /// @brief 时间面元素个数 2*H*W
+    inline size_t timeSurfaceSize() const noexcept {
+        return 2 * mPixels;
+    }
+
+    /// @brief 按极性统计事件数
+    /// @param out 布局 [2][H][W]，通道 0 为负极性，通道 1 为正极性
+    /// @param accumulate 为 true 时在原有内容上累加
+    void countImage(const Metavision::EventCD *begin, const Metavision::EventCD *end, float *out,
+                    bool accumulate = false);
+
+    /// @brief 体素网格：事件极性（±1）在时间维上按双线性权重分配到相邻两个时间格
+    /// @details 事件归一化时间为 (t - tStart) * (bins - 1) / (tEnd - tStart)，落在 [0, bins-1] 之外的权重被丢弃。
+    /// @param out 布局 [bins][H][W]
+    void voxelGrid(const Metavision::EventCD *begin, const Metavision::EventCD *end, Metavision::timestamp tStart,
+                   Metavision::timestamp tEnd, int bins, float *out, bool accumulate = false);
+
+    /// @brief 事件脉冲张量：按极性分开，每个事件以三角核在时间维上计数
+    /// @param out 布局 [2][bins][H][W]
+    void eventSpikeTensor(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                          Metavision::timestamp tStart, Metavision::timestamp tEnd, int bins, float *out,
+                          bool accumulate = false);
+
+    /// @brief 用新事件更新内部 SAE（每像素每极性最近时间戳），供 timeSurface 增量渲染
+    void update(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 由 SAE 渲染指数衰减时间面 exp(-(t - t_last) / tau)
+    /// @param t 渲染时刻，晚于 t 的事件按 t 处理
+    /// @param tau 衰减时间常数（微秒）
+    /// @param out 布局 [2][H][W]，从未触发的像素为 0
+    void timeSurface(Metavision::timestamp t, double tau, float *out);
+
+    /// @brief 清空 SAE
+    void reset();
+
+    /// @brief SAE，布局 [2][H][W]，从未触发的像素为 kNoEvent
+    inline const std::vector<Metavision::timestamp> &sae() const noexcept {
+        return mSae;
+    }
+
+    static constexpr Metavision::timestamp kNoEvent = INT64_MIN;
+
+private:
+    int mWidth;
+    int mHeight;
+    size_t mPixels;
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    Utils::EventPartitioner mPartitioner;
+    std::vector<Metavision::timestamp> mSae;
+
+    /// @brief 按行带并行执行 body(rowBegin, rowEnd)
+    template <typename Body>
+    void forEachRows(const Body &body);
+
+    /// @brief 清零 planes 个 [H][W] 平面
+    void clear(float *out, size_t planes);
+
+    /// @brief 在时间维上双线性累积
+    /// @param signedPolarity 为 true 时累积 ±1，否则累积 1
+    /// @param polarityStride 正极性相对负极性的偏移，0 表示不区分极性
+    void accumulateTemporal(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                            Metavision::timestamp tStart, Metavision::timestamp tEnd, int bins, float *out,
+                            bool signedPolarity, size_t polarityStride);
+};
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV_EVENT_REPRESENTATION_H
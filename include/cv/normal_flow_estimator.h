@@ -0,0 +1,149 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV_NORMAL_FLOW_ESTIMATOR_H
+#define SHIMETA_SDK_ALGORITHM_CV_NORMAL_FLOW_ESTIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/event_partitioner.h"
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+/// @brief 带法向光流的事件
+struct FlowEvent {
+    unsigned short x;
+    unsigned short y;
+    short p;
+    Metavision::timestamp t;
+    float vx; // 像素/秒
+    float vy; // 像素/秒
+};
+
+/// @brief 按网格单元平均的稠密光流场
+struct DenseFlowField {
+    int cellSize = 0;
+    int width = 0;                 // 单元列数
+    int height = 0;                // 单元行数
+    Metavision::timestamp t = 0;   // 统计周期的结束时刻
+    std::vector<float> vx;         // [height][width]，像素/秒
+    std::vector<float> vy;
+    std::vector<uint32_t> count;   // 单元内有效光流事件数，0 表示无估计
+};
+
+/// @brief Event-based normal flow from local plane fits on the SAE.
+/// @details 为每个极性维护 SAE（每像素最近时间戳）。每个事件在 (2r+1)x(2r+1) 邻域内收集同极性、
+/// 时间窗口内的时间戳，最小二乘拟合局部平面 t = a*x + b*y + c，法向光流为 (a, b) / (a^2 + b^2)。
+/// 拟合只累积固定大小的和式，不分配内存；可选地剔除残差过大的点后重拟合一次。
+/// 传感器按固定高度的行带（tile）划分，偶数与奇数行带分两轮在线程池上并行，邻域读写不会跨越正在处理的行带；
+/// 因此结果与线程数无关，但行带边界处的事件在同一批次内看不到相邻行带中的较早事件。
+class NormalFlowEstimator {
+public:
+    using FieldCallback = std::function<void(const DenseFlowField &)>;
+
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param radius 邻域半径（1~7）
+    /// @param duration 参与拟合的时间窗口（微秒）
+    /// @param minNeighbors 拟合所需的最少点数（含当前事件）
+    /// @param fitTolerance 重拟合时剔除残差超过该值（微秒）的点，0 表示不重拟合
+    /// @param tileRows 行带高度，不小于 radius
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程
+    NormalFlowEstimator(
+        int width,
+        int height,
+        int radius = 2,
+        Metavision::timestamp duration = 20000,
+        int minNeighbors = 6,
+        double fitTolerance = 1000.0,
+        int tileRows = 32,
+        size_t threads = 0
+    );
+
+    /// @brief 清空 SAE 与稠密光流场的统计
+    void initialize();
+
+    /// @brief 启用稠密光流场输出
+    /// @param cellSize 网格单元边长（像素）
+    /// @param period 输出周期（微秒），事件时间跨过周期边界时调用 callback
+    /// @param callback 接收每个周期的光流场
+    void setFieldOutput(int cellSize, Metavision::timestamp period, FieldCallback callback);
+
+    /// @brief 批量估计法向光流
+    /// @param out 清空后按输入顺序写入拟合成功的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<FlowEvent> &out);
+
+    /// @brief 批量估计法向光流
+    /// @param events 输入事件向量
+    /// @return 拟合成功的事件及其光流
+    std::vector<FlowEvent> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 最近一次输出的稠密光流场
+    inline const DenseFlowField &field() const noexcept {
+        return mField;
+    }
+
+private:
+    int mWidth;
+    int mHeight;
+    int mRadius;
+    Metavision::timestamp mDuration;
+    int mMinNeighbors;
+    double mFitTolerance;
+
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    Utils::EventPartitioner mPartitioner;
+    std::vector<Metavision::timestamp> mSae; // [2][H][W]
+    std::vector<float> mFlow;                // 每个输入事件的 (vx, vy)，NaN 表示拟合失败
+
+    Metavision::timestamp mFieldPeriod;
+    Metavision::timestamp mFieldEnd;
+    FieldCallback mFieldCallback;
+    DenseFlowField mField;
+    std::vector<double> mSumX;
+    std::vector<double> mSumY;
+    std::vector<uint32_t> mSumCount;
+
+    /// @brief 拟合单个事件的法向光流并更新 SAE
+    /// @return 拟合成功返回 true
+    bool fit(const Metavision::EventCD &event, float &vx, float &vy);
+
+    /// @brief 处理一个行带内的全部事件
+    void processBand(size_t band);
+
+    /// @brief 把有效光流累积到稠密光流场，必要时输出
+    void accumulateField(const FlowEvent &flow);
+
+    /// @brief 输出当前周期的光流场并清空统计
+    void emitField();
+};
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV_NORMAL_FLOW_ESTIMATOR_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV3D_EVENT_UNDISTORTER_H
+#define SHIMETA_SDK_ALGORITHM_CV3D_EVENT_UNDISTORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+/// @brief 针孔相机内参与 OpenCV 五参数畸变模型（k1, k2, p1, p2, k3）
+struct CameraModel {
+    double fx = 0.0;
+    double fy = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+    double k1 = 0.0;
+    double k2 = 0.0;
+    double p1 = 0.0;
+    double p2 = 0.0;
+    double k3 = 0.0;
+};
+
+/// @brief Lookup-table based undistortion and rectification of event coordinates.
+/// @details 构造时为每个传感器像素按 cv::undistortPoints 的迭代方法求去畸变坐标，可选地乘以校正旋转并投影到新的内参，
+/// 结果以 1/16 像素的定点数打包进每像素一个 uint32 的查找表；映射到输出范围之外的像素标记为无效。
+/// 逐事件处理只需一次查表和无分支的写入压缩，无效事件被丢弃。
+/// 指定 cachePath 时，查找表与全部参数一起保存为状态快照；下次以相同参数构造时直接内存映射读取，不再重新计算。
+class EventUndistorter {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param camera 原始相机内参与畸变系数
+    /// @param rectification 校正旋转，作用于去畸变后的归一化坐标
+    /// @param target 输出内参，fx 为 0 时沿用 camera 的内参；畸变系数被忽略
+    /// @param outWidth 输出宽度，0 表示与 width 相同，不超过 4096
+    /// @param outHeight 输出高度，0 表示与 height 相同，不超过 4096
+    /// @param cachePath 查找表缓存文件，为空时不使用缓存
+    EventUndistorter(
+        int width,
+        int height,
+        const CameraModel &camera,
+        const Eigen::Matrix3d &rectification = Eigen::Matrix3d::Identity(),
+        const CameraModel &target = CameraModel{},
+        int outWidth = 0,
+        int outHeight = 0,
+        const std::string &cachePath = ""
+    );
+
+    /// @brief 映射事件坐标并丢弃越界事件
+    /// @param out 清空后按输入顺序写入映射后的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
+    /// @brief 映射事件坐标并丢弃越界事件
+    /// @param events 输入事件向量
+    /// @return 映射后的事件
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 查询单个像素的亚像素映射结果
+    /// @return 像素越界或映射无效时返回 false
+    bool map(int x, int y, float &u, float &v) const noexcept;
+
+    /// @brief 把查找表与参数写入缓存文件
+    void saveCache(const std::string &path) const;
+
+    /// @brief 查找表是否来自缓存文件
+    inline bool loadedFromCache() const noexcept {
+        return mFromCache;
+    }
+
+    /// @brief 输出宽度
+    inline int outputWidth() const noexcept {
+        return mOutWidth;
+    }
+
+    /// @brief 输出高度
+    inline int outputHeight() const noexcept {
+        return mOutHeight;
+    }
+
+    /// @brief 定点坐标的小数位数
+    static constexpr int kFractionBits = 4;
+
+    /// @brief 无效映射
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+private:
+    int mWidth;
+    int mHeight;
+    int mOutWidth;
+    int mOutHeight;
+    std::vector<double> mParameters; // 参与计算的全部参数，用于校验缓存
+    std::vector<uint32_t> mLut;      // [H][W]，(y << 16) | x，定点数
+    bool mFromCache;
+
+    /// @brief 计算查找表
+    void build(const CameraModel &camera, const Eigen::Matrix3d &rectification, const CameraModel &target);
+
+    /// @brief 从缓存文件读取查找表，参数不一致或文件无效时返回 false
+    bool loadCache(const std::string &path);
+};
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV3D_EVENT_UNDISTORTER_H
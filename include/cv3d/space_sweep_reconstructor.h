@@ -0,0 +1,170 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV3D_SPACE_SWEEP_RECONSTRUCTOR_H
+#define SHIMETA_SDK_ALGORITHM_CV3D_SPACE_SWEEP_RECONSTRUCTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+/// @brief 相机位姿（相机坐标系到世界坐标系）
+struct CameraPose {
+    Metavision::timestamp t;
+    Eigen::Quaternionf rotation;
+    Eigen::Vector3f position;
+};
+
+/// @brief 半稠密点云中的点（世界坐标系）
+struct CloudPoint {
+    float x;
+    float y;
+    float z;
+    float confidence; // 射线交汇的票数
+};
+
+/// @brief Space-sweep 3D reconstruction (EMVS) from a single event camera with known motion.
+/// @details 在参考视角上建立视差空间图像（DSI）：参考相机像素网格 x depthPlanes 个按逆深度均匀分布的深度平面。
+/// 每个事件按其时刻插值出的相机位姿反投影为一条射线，射线与第 i 个深度平面的交点在参考图像上的坐标是逆深度的线性函数，
+/// 因此逐平面只需一次乘加，再以双线性权重投票。投票分两步并行：先按事件块计算射线参数，再按深度平面分段投票，
+/// 各线程写互不重叠的平面，结果与线程数无关。事件按固定大小的块流式处理，内存只取决于 DSI 分辨率。
+/// extract() 沿每条参考射线取 DSI 最大值作为置信度和深度，用局部均值自适应阈值保留射线交汇明显的像素，
+/// 并在相邻平面间做抛物线插值，输出半稠密深度图与点云。输入事件应已去畸变。
+class SpaceSweepReconstructor {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度，也是 DSI 的宽度
+    /// @param height 传感器高度，也是 DSI 的高度
+    /// @param fx 焦距 x（像素）
+    /// @param fy 焦距 y（像素）
+    /// @param cx 主点 x（像素）
+    /// @param cy 主点 y（像素）
+    /// @param minDepth 最近深度平面
+    /// @param maxDepth 最远深度平面
+    /// @param depthPlanes 深度平面数
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程
+    SpaceSweepReconstructor(
+        int width,
+        int height,
+        float fx,
+        float fy,
+        float cx,
+        float cy,
+        float minDepth,
+        float maxDepth,
+        int depthPlanes = 100,
+        size_t threads = 0
+    );
+
+    /// @brief 清空 DSI，保留轨迹与参考位姿
+    void initialize();
+
+    /// @brief 追加轨迹上的位姿，时间戳需严格递增
+    void addPose(const CameraPose &pose);
+
+    /// @brief 清空轨迹
+    void clearTrajectory();
+
+    /// @brief 按时刻插值位姿（平移线性插值、旋转球面插值）
+    /// @return 时刻超出轨迹范围时返回 false
+    bool poseAt(Metavision::timestamp t, CameraPose &pose) const;
+
+    /// @brief 设置 DSI 的参考视角，并清空 DSI
+    void setReference(const CameraPose &pose);
+
+    /// @brief 以轨迹在 t 时刻的位姿作为参考视角，并清空 DSI
+    void setReference(Metavision::timestamp t);
+
+    /// @brief 事件投票进 DSI
+    /// @return 参与投票的事件数，超出轨迹范围的事件被跳过
+    size_t process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 事件投票进 DSI
+    size_t process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 从 DSI 提取半稠密深度图与点云
+    /// @param cloud 清空后写入点云（世界坐标系），按参考图像的行优先顺序
+    /// @param thresholdOffset 置信度需超过局部均值的票数
+    /// @param filterRadius 局部均值的窗口半径
+    /// @param depthMap 可选，大小 height*width，未保留的像素为 0
+    /// @param confidenceMap 可选，大小 height*width，每条射线的最大票数
+    void extract(std::vector<CloudPoint> &cloud, float thresholdOffset = 5.0f, int filterRadius = 2,
+                 float *depthMap = nullptr, float *confidenceMap = nullptr);
+
+    /// @brief DSI 数据，[depthPlanes][height][width]，平面 0 为最近
+    inline const float *dsi() const noexcept {
+        return mDsi.data();
+    }
+
+    /// @brief 第 plane 个深度平面的深度
+    inline float planeDepth(int plane) const noexcept {
+        return 1.0f / (mInverseNear - plane * mInverseStep);
+    }
+
+    /// @brief 深度平面数
+    inline int depthPlanes() const noexcept {
+        return mPlanes;
+    }
+
+private:
+    /// @brief 射线在参考图像上的轨迹：u = uA + uB * w，v = vA + vB * w，w 为逆深度
+    struct Ray {
+        float uA;
+        float uB;
+        float vA;
+        float vB;
+        float wLimit; // 逆深度上限，保证交点位于事件相机前方
+    };
+
+    int mWidth;
+    int mHeight;
+    float mFx;
+    float mFy;
+    float mCx;
+    float mCy;
+    int mPlanes;
+    float mInverseNear;
+    float mInverseStep;
+
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    std::vector<CameraPose> mTrajectory;
+    CameraPose mReference;
+    std::vector<float> mDsi;
+    std::vector<Ray> mRays;
+    std::vector<uint8_t> mRayValid;
+
+    /// @brief 计算一块事件的射线参数
+    void computeRays(const Metavision::EventCD *begin, size_t count);
+
+    /// @brief 把 mRays 中的射线投票到 [firstPlane, lastPlane) 平面
+    void vote(size_t count, size_t firstPlane, size_t lastPlane);
+};
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV3D_SPACE_SWEEP_RECONSTRUCTOR_H
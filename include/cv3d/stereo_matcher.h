@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_CV3D_STEREO_MATCHER_H
+#define SHIMETA_SDK_ALGORITHM_CV3D_STEREO_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/event_partitioner.h"
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+/// @brief 带视差与深度的事件（左相机坐标）
+struct DepthEvent {
+    unsigned short x;
+    unsigned short y;
+    short p;
+    Metavision::timestamp t;
+    float disparity; // 像素，右相机列 = x - disparity
+    float depth;     // 与 baseline 相同的单位
+};
+
+/// @brief Event-based stereo matcher for a rectified, synchronized camera pair.
+/// @details 为右相机的每个极性维护按行存放的时间面（32 位相对时间戳）。左相机的每个事件沿同一行（极线）
+/// 在 [minDisparity, maxDisparity] 范围内扫描同极性的时间面，代价为时间差的绝对值，取最小代价的视差；
+/// 代价超过 maxTimeDiff 或次优代价（与最优视差相距超过 1 像素）不够大时判为无匹配。
+/// 视差扫描是定长、无分支的连续内存循环，由编译器自动向量化；最优视差两侧的代价用于 V 形亚像素插值。
+/// 两路事件按行带划分后在线程池上并行，行带内按时间归并：匹配左事件前先写入时间不晚于 t + maxTimeDiff 的右事件。
+/// 因此批次末尾 maxTimeDiff 内的左事件会推迟到下一批（或 flush）再匹配。
+/// rowTolerance 大于 0 时同时扫描上下相邻的行，行带分偶数、奇数两轮处理，行带边界处存在与 CornerDetector 相同的批内滞后。
+class StereoMatcher {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度（两路相同，已校正）
+    /// @param height 传感器高度
+    /// @param focalLength 校正后的焦距（像素）
+    /// @param baseline 基线长度，深度与其单位相同
+    /// @param minDisparity 最小视差（像素）
+    /// @param maxDisparity 最大视差（像素），不超过 1023
+    /// @param maxTimeDiff 时间一致的最大时间差（微秒）
+    /// @param uniqueness 次优代价与最优代价之比的下限
+    /// @param rowTolerance 额外扫描的上下行数，用于容忍校正误差
+    /// @param tileRows 并行行带高度
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程
+    StereoMatcher(
+        int width,
+        int height,
+        float focalLength,
+        float baseline,
+        int minDisparity = 0,
+        int maxDisparity = 64,
+        Metavision::timestamp maxTimeDiff = 1000,
+        float uniqueness = 1.5f,
+        int rowTolerance = 0,
+        int tileRows = 32,
+        size_t threads = 0
+    );
+
+    /// @brief 清空时间面、深度图与待匹配的事件
+    void initialize();
+
+    /// @brief 批量匹配
+    /// @details 两路输入各自按时间排序，且覆盖大致相同的时间段。
+    /// @param out 清空后按时间顺序写入匹配成功的左事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *leftBegin, const Metavision::EventCD *leftEnd,
+                        const Metavision::EventCD *rightBegin, const Metavision::EventCD *rightEnd,
+                        std::vector<DepthEvent> &out);
+
+    /// @brief 批量匹配
+    /// @param left 左相机事件
+    /// @param right 右相机事件
+    /// @return 匹配成功的左事件
+    std::vector<DepthEvent> process_events(const std::vector<Metavision::EventCD> &left,
+                                           const std::vector<Metavision::EventCD> &right);
+
+    /// @brief 用当前时间面匹配所有推迟的左事件，用于流结束时
+    void flush(std::vector<DepthEvent> &out);
+
+    /// @brief 生成半稠密深度图
+    /// @param t 当前时刻
+    /// @param maxAge 深度的最长保留时间（微秒）
+    /// @param out 输出深度图，大小 height*width，没有近期深度的像素为 0
+    void depthMap(Metavision::timestamp t, Metavision::timestamp maxAge, float *out);
+
+    /// @brief 视差转深度
+    inline float depthFromDisparity(float disparity) const noexcept {
+        return disparity > 0.0f ? mFocalBaseline / disparity : 0.0f;
+    }
+
+    /// @brief 推迟到下一批的左事件数
+    inline size_t pendingEvents() const noexcept {
+        return mPending.size();
+    }
+
+    static constexpr int kMaxDisparity = 1023;
+
+private:
+    int mWidth;
+    int mHeight;
+    float mFocalBaseline;
+    int mMinDisparity;
+    int mMaxDisparity;
+    Metavision::timestamp mMaxTimeDiff;
+    float mUniqueness;
+    int mRowTolerance;
+
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    Utils::EventPartitioner mLeftPartitioner;
+    Utils::EventPartitioner mRightPartitioner;
+
+    bool mHasBase;
+    Metavision::timestamp mBase;             // 32 位相对时间戳的基准
+    std::vector<int32_t> mRightSurface;      // [2][H][W]，相对时间戳
+    std::vector<float> mDepth;               // [H][W]
+    std::vector<Metavision::timestamp> mDepthTime;
+    std::vector<Metavision::EventCD> mLeft;  // 推迟的左事件 + 本批左事件
+    std::vector<Metavision::EventCD> mPending;
+    std::vector<float> mDisparity;           // 每个左事件的视差，NaN 表示无匹配
+
+    /// @brief 必要时平移相对时间戳的基准，保证 32 位不溢出
+    void rebase(Metavision::timestamp first, Metavision::timestamp last);
+
+    /// @brief 处理一个行带：按时间归并两路事件并逐个匹配左事件
+    void processBand(size_t band);
+
+    /// @brief 沿极线扫描视差
+    /// @return 亚像素视差，无匹配时返回 NaN
+    float match(const Metavision::EventCD &event) const;
+
+    /// @brief 匹配 mLeft 的前 count 个事件并按时间顺序输出
+    void run(size_t count, const Metavision::EventCD *rightBegin, const Metavision::EventCD *rightEnd,
+             std::vector<DepthEvent> &out);
+};
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_CV3D_STEREO_MATCHER_H
@@ -19,6 +19,7 @@
 #include <vector>
 #include <cmath>
 #include <deque>
+#include <string>
 
 #include <metavision/sdk/base/events/event_cd.h>
 #include <metavision/sdk/base/events/event_cd_vector.h>
@@ -70,10 +71,23 @@ public:
         return evaluate(event);
     }
 
+    /// @brief Process a range of events.
+    /// @param out Cleared, then filled with the retained events in input order; its capacity is reused across calls.
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief Process a vector of events.
     /// @param events The vector of events to process.
     /// @return A vector containing only the retained events.
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief Save the filter state to a binary snapshot.
+    /// @param path Snapshot file path.
+    void save_state(const std::string &path) const;
+
+    /// @brief Restore the filter state from a snapshot written by save_state.
+    /// @param path Snapshot file path.
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
@@ -20,6 +20,7 @@
 #include <deque>
 #include <Eigen/Dense>
 #include <cmath>
+#include <string>
 #include <metavision/sdk/base/events/event_cd.h>
 
 namespace Shimeta {
@@ -68,10 +69,23 @@ public:
         return evaluate(event);
     }
 
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief 批量处理事件
     /// @param events 输入事件向量
     /// @return 保留的事件向量
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_DENOISE_FUSED_PIPELINE_H
+#define SHIMETA_SDK_ALGORITHM_DENOISE_FUSED_PIPELINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+namespace Detail {
+/// @brief 滤波器是否提供 process_events(begin, end, out) 批量接口
+template <typename Filter, typename = void>
+struct HasRangeProcess : std::false_type {};
+
+template <typename Filter>
+struct HasRangeProcess<Filter, std::void_t<decltype(std::declval<Filter &>().process_events(
+    std::declval<const Metavision::EventCD *>(), std::declval<const Metavision::EventCD *>(),
+    std::declval<std::vector<Metavision::EventCD> &>()))>> : std::true_type {};
+} // namespace Detail
+
+/// @brief Single-pass chain of denoising filters resolved at compile time.
+/// @details 每个事件依次经过各级滤波器的 retain()，遇到第一个剔除即停止，后续各级看不到该事件，
+/// 因此输出与逐级调用 process_events() 串联完全一致（前提是各级的批量处理与逐事件 retain() 等价）。
+/// 各级类型在编译期确定，没有虚函数调用，也没有按批次大小分配的级间向量，整个链只遍历一次输入。
+/// 流水线只保存各级的引用，滤波器的构造、初始化与状态快照仍由调用方管理。
+/// 典型用法：FusedPipeline pipeline(hotPixel, refractory, yang);
+template <typename... Filters>
+class FusedPipeline {
+    static_assert(sizeof...(Filters) > 0, "FusedPipeline needs at least one stage");
+
+public:
+    /// @brief 构造函数
+    /// @param filters 按处理顺序排列的各级滤波器，生命周期需长于流水线
+    explicit FusedPipeline(Filters &...filters) : mStages(filters...) {}
+
+    /// @brief 处理单个事件
+    /// @return 通过全部各级时返回 true
+    inline bool retain(const Metavision::EventCD &event) {
+        return std::apply([&event](Filters &...filters) { return (filters.retain(event) && ...); }, mStages);
+    }
+
+    /// @brief 处理单个事件
+    inline bool evaluate(const Metavision::EventCD &event) {
+        return retain(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @details 按 kBlockSize 个事件分块，块内逐级筛选：每级只处理上一级保留下来的事件，结果写入两个
+    /// 块大小的缓冲区之一（交替使用），块与缓冲区都留在 L1 中，因此整条链仍只遍历一次输入内存。
+    /// 提供 process_events(begin, end, out) 的滤波器直接用它处理整块，以利用其批量路径；其余按 retain() 逐事件筛选。
+    /// 各级状态互相独立，因此结果与逐事件 retain() 相同。
+    /// @param out 清空后按输入顺序写入通过全部各级的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out) {
+        out.clear();
+        for (const Metavision::EventCD *block = begin; block != end;) {
+            const size_t size = std::min<size_t>(kBlockSize, static_cast<size_t>(end - block));
+            const Metavision::EventCD *events = block;
+            size_t count = size;
+            size_t buffer = 0;
+            std::apply([&](Filters &...filters) { (runStage(filters, events, count, buffer), ...); }, mStages);
+            out.insert(out.end(), events, events + count);
+            block += size;
+        }
+    }
+
+    /// @brief 批量处理事件
+    /// @param events 输入事件向量
+    /// @return 通过全部各级的事件
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events) {
+        std::vector<Metavision::EventCD> retained;
+        process_events(events.data(), events.data() + events.size(), retained);
+        return retained;
+    }
+
+    /// @brief 第 I 级滤波器
+    template <size_t I>
+    inline auto &stage() noexcept {
+        return std::get<I>(mStages);
+    }
+
+    /// @brief 级数
+    static constexpr size_t size() noexcept {
+        return sizeof...(Filters);
+    }
+
+    /// @brief 批量处理时每块的事件数
+    static constexpr size_t kBlockSize = 1024;
+
+private:
+    std::tuple<Filters &...> mStages;
+
+    std::vector<Metavision::EventCD> mBuffers[2];
+
+    /// @brief 用一级滤波器处理当前块中保留下来的事件，结果写入下一个缓冲区
+    template <typename Filter>
+    inline void runStage(Filter &filter, const Metavision::EventCD *&events, size_t &count, size_t &buffer) {
+        if (count == 0) {
+            return;
+        }
+        std::vector<Metavision::EventCD> &next = mBuffers[buffer];
+        buffer ^= 1;
+        if constexpr (Detail::HasRangeProcess<Filter>::value) {
+            filter.process_events(events, events + count, next);
+            count = next.size();
+        } else {
+            next.resize(count);
+            size_t kept = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const bool keep = filter.retain(events[i]);
+                next[kept] = events[i];
+                kept += keep ? 1 : 0;
+            }
+            count = kept;
+        }
+        events = next.data();
+    }
+};
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_DENOISE_FUSED_PIPELINE_H
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_DENOISE_HOT_PIXEL_FILTER_H
+#define SHIMETA_SDK_ALGORITHM_DENOISE_HOT_PIXEL_FILTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+/// @brief Hot/dead pixel mask stage for CD events.
+/// @details 该滤波器在学习窗口内统计每个像素的事件率，将事件率过高（热像素）或过低（坏像素）的像素记录在位掩码中，
+/// 之后每个事件只需一次位测试即可剔除。适合放在滤波链的最前端，掩码可保存到文件并在启动时加载。
+class HotPixelFilter {
+private:
+    int mWidth;
+    int mHeight;
+    double mHotRateThreshold;   // events/s
+    double mDeadRateThreshold;  // events/s
+    int64_t mLearningDuration;  // us
+    bool mContinuousLearning;
+
+    std::vector<uint64_t> mMask;
+    std::vector<uint32_t> mEventCounts;
+    int64_t mWindowStart;
+    bool mLearning;
+    size_t mHotPixelCount;
+    size_t mDeadPixelCount;
+
+    /// @brief 像素在掩码中的位索引
+    inline size_t index(int x, int y) const noexcept {
+        return static_cast<size_t>(y) * mWidth + x;
+    }
+
+    /// @brief 将事件计入当前学习窗口
+    void accumulate(const Metavision::EventCD &event);
+
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param hotRateThreshold 热像素事件率阈值（事件/秒），不低于该值的像素被屏蔽
+    /// @param deadRateThreshold 坏像素事件率阈值（事件/秒），低于该值的像素被屏蔽，0 表示不检测
+    /// @param learningDuration 学习窗口长度（微秒）
+    /// @param continuousLearning 为 true 时每个学习窗口结束后重新生成掩码，否则只学习一次
+    HotPixelFilter(
+        int width,
+        int height,
+        double hotRateThreshold = 1000.0,
+        double deadRateThreshold = 0.0,
+        int64_t learningDuration = 1000000,
+        bool continuousLearning = false
+    );
+
+    /// @brief 清空掩码并重新开始学习
+    void initialize();
+
+    /// @brief 用标定录像中的事件累积像素事件率，不做过滤
+    /// @param events 输入事件向量
+    void learn(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 根据已累积的事件计数生成掩码并结束当前学习窗口
+    /// @param duration 计数覆盖的时长（微秒）
+    void updateMask(int64_t duration);
+
+    /// @brief 判断单个事件是否为信号
+    /// @param event 输入事件
+    /// @return true为信号，false为被屏蔽像素的事件
+    inline bool evaluate(const Metavision::EventCD &event) {
+        if (mLearning || mContinuousLearning) {
+            accumulate(event);
+        }
+        return !isMasked(event.x, event.y);
+    }
+
+    /// @brief 处理单个事件
+    inline bool retain(const Metavision::EventCD &event) noexcept {
+        return evaluate(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
+    /// @brief 批量处理事件
+    /// @param events 输入事件向量
+    /// @return 保留的事件向量
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 查询像素是否被屏蔽
+    inline bool isMasked(int x, int y) const noexcept {
+        const size_t i = index(x, y);
+        return (mMask[i >> 6] >> (i & 63)) & 1U;
+    }
+
+    /// @brief 手动屏蔽或取消屏蔽像素
+    void setMasked(int x, int y, bool masked);
+
+    /// @brief 是否仍处于首个学习窗口内（此时不屏蔽任何事件）
+    inline bool isLearning() const noexcept {
+        return mLearning;
+    }
+
+    /// @brief 最近一次生成掩码时检测到的热像素数
+    inline size_t hotPixelCount() const noexcept {
+        return mHotPixelCount;
+    }
+
+    /// @brief 最近一次生成掩码时检测到的坏像素数
+    inline size_t deadPixelCount() const noexcept {
+        return mDeadPixelCount;
+    }
+
+    /// @brief 将掩码保存到二进制文件
+    /// @param path 文件路径
+    void saveMask(const std::string &path) const;
+
+    /// @brief 从二进制文件加载掩码，加载后停止首次学习
+    /// @param path 文件路径
+    void loadMask(const std::string &path);
+
+    /// @brief 传感器宽度
+    inline int width() const noexcept {
+        return mWidth;
+    }
+
+    /// @brief 传感器高度
+    inline int height() const noexcept {
+        return mHeight;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
+};
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_DENOISE_HOT_PIXEL_FILTER_H
@@ -17,6 +17,7 @@
 #define SHIMETA_SDK_ALGORITHM_DENOISE_KHODAMORADI_DENOISER_H
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include <metavision/sdk/base/events/event_cd.h>
@@ -50,11 +51,39 @@ public:
     /// @return 是否为信号
     bool filter(const Metavision::EventCD &event);
 
+    /// @brief 处理单个事件，与 filter 相同
+    inline bool retain(const Metavision::EventCD &event) {
+        return filter(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief 批量处理事件
     /// @param events 输入事件向量
     /// @return 保留的事件向量
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
 
+    /// @brief 传感器宽度
+    inline int width() const noexcept {
+        return width_;
+    }
+
+    /// @brief 传感器高度
+    inline int height() const noexcept {
+        return height_;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
+
 private:
     uint16_t width_;
     uint16_t height_;
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_DENOISE_LOAD_SHEDDING_CONTROLLER_H
+#define SHIMETA_SDK_ALGORITHM_DENOISE_LOAD_SHEDDING_CONTROLLER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+/// @brief Rate-adaptive load shedding controller for denoising chains.
+/// @details 该控制器按批测量输入事件率与处理耗时，并估计相对于传感器时间的累积延迟。当延迟接近预算时，
+/// 逐级切换到更廉价的处理级别（更便宜的滤波器、更小的半径或空间降采样）；负载下降并持续若干批后再逐级恢复。
+/// 每次切换都会通过回调上报。级别 0 为最昂贵（质量最高）的级别。
+class LoadSheddingController {
+public:
+    /// @brief 处理级别，输入一批事件并返回保留的事件
+    using Stage = std::function<std::vector<Metavision::EventCD>(const std::vector<Metavision::EventCD> &)>;
+
+    /// @brief 级别切换记录
+    struct ModeSwitch {
+        size_t fromLevel;
+        size_t toLevel;
+        std::string fromName;
+        std::string toName;
+        Metavision::timestamp t; // 触发切换的批次最后一个事件的时间戳
+        double inputRate;        // 输入事件率（事件/秒）
+        double utilization;      // 处理耗时 / 传感器时间
+        double latency;          // 估计延迟（微秒）
+    };
+
+    using ModeSwitchCallback = std::function<void(const ModeSwitch &)>;
+
+    /// @brief 构造函数
+    /// @param latencyBudget 延迟预算（微秒）
+    /// @param degradeRatio 估计延迟超过 预算*degradeRatio 时降级
+    /// @param recoverRatio 估计延迟低于 预算*recoverRatio 时才考虑恢复
+    /// @param recoverBatches 连续满足恢复条件的批次数
+    explicit LoadSheddingController(
+        int64_t latencyBudget = 20000,
+        double degradeRatio = 0.8,
+        double recoverRatio = 0.5,
+        size_t recoverBatches = 10
+    );
+
+    /// @brief 添加处理级别，按从最昂贵到最廉价的顺序添加
+    /// @param name 级别名称，用于上报
+    /// @param stage 处理函数
+    /// @return 级别编号
+    size_t addLevel(const std::string &name, Stage stage);
+
+    /// @brief 设置级别切换回调
+    void setModeSwitchCallback(ModeSwitchCallback callback);
+
+    /// @brief 重置统计量并回到级别 0
+    void initialize();
+
+    /// @brief 用当前级别处理一批事件，并根据测量结果调整级别
+    /// @param events 输入事件向量（时间戳单调不减）
+    /// @return 保留的事件向量
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 空间降采样，只保留坐标为 stride 整数倍的像素上的事件
+    /// @param events 输入事件向量
+    /// @param stride 降采样步长
+    /// @return 保留的事件向量
+    static std::vector<Metavision::EventCD> subsample(const std::vector<Metavision::EventCD> &events, int stride);
+
+    inline size_t level() const noexcept { return mLevel; }
+    inline const std::string &levelName() const { return mLevels[mLevel].name; }
+    inline size_t levelCount() const noexcept { return mLevels.size(); }
+    inline double inputRate() const noexcept { return mInputRate; }
+    inline double utilization() const noexcept { return mUtilization; }
+    inline double latency() const noexcept { return mLatency; }
+    inline size_t switchCount() const noexcept { return mSwitchCount; }
+
+private:
+    struct Level {
+        std::string name;
+        Stage stage;
+        double costPerEvent; // 每个事件的处理耗时（微秒），负数表示尚未测量
+    };
+
+    int64_t mLatencyBudget;
+    double mDegradeRatio;
+    double mRecoverRatio;
+    size_t mRecoverBatches;
+
+    std::vector<Level> mLevels;
+    ModeSwitchCallback mCallback;
+
+    size_t mLevel;
+    size_t mCalmBatches;
+    size_t mSwitchCount;
+    Metavision::timestamp mLastEventTime;
+    double mBacklog;     // us
+    double mLatency;     // us
+    double mInputRate;   // events/s
+    double mUtilization;
+
+    /// @brief 切换到指定级别并上报
+    void switchTo(size_t level, Metavision::timestamp t);
+};
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_DENOISE_LOAD_SHEDDING_CONTROLLER_H
@@ -20,6 +20,7 @@
 #include <cmath>
 #include <filesystem>
 #include <memory>
+#include <string>
 
 #include <metavision/sdk/base/events/event_cd.h>
 #include <metavision/sdk/base/events/event_cd_vector.h>
@@ -29,6 +30,8 @@
 #include <torch/script.h>
 #include <torch/torch.h>
 
+#include "utils/pixel_surface.h"
+
 namespace fs = std::filesystem;
 
 namespace Shimeta {
@@ -54,7 +57,7 @@ private:
     const int16_t mInputVolume = mInputDepth * mInputWidth * mInputHeight;
 
     // Time surface for maintaining event history
-    std::vector<std::vector<Metavision::EventCD>> mTimeSurface;
+    Utils::PixelSurface<Metavision::EventCD> mTimeSurface;
     
     // Offset patterns for neighborhood lookup
     std::vector<std::pair<int, int>> mOffsets;
@@ -65,6 +68,10 @@ private:
     // Event batch buffer
     std::vector<Metavision::EventCD> mEventBuffer;
 
+    // Batch copy and classification mask reused by the range process_events
+    std::vector<Metavision::EventCD> mBatch;
+    std::vector<uint8_t> mMask;
+
     /// @brief Parse device string to torch::Device
     /// @param deviceStr Device string ("cpu", "cuda:0", etc.)
     /// @return Corresponding torch::Device object
@@ -92,6 +99,11 @@ private:
     /// @return Vector of events classified as signal
     std::vector<Metavision::EventCD> processBatch(const std::vector<Metavision::EventCD> &events);
 
+    /// @brief Classify a batch of events through the neural network
+    /// @param events Vector of events to process
+    /// @param mask Output, set to 1 for events classified as signal
+    void classifyBatch(const std::vector<Metavision::EventCD> &events, uint8_t *mask);
+
 public:
     /// @brief Constructor
     /// @param resolution Resolution of the sensor (width, height)
@@ -100,13 +112,15 @@ public:
     /// @param duration Time duration for temporal features (in microseconds)
     /// @param floatThreshold Threshold for neural network output
     /// @param device Device name ("cpu" for CPU, "cuda:0" for first GPU, etc.)
+    /// @param layout Memory layout of the time surface read by the 7x7 feature extraction
     explicit MultiLayerPerceptronFilter(
         const std::pair<int, int> &resolution,
         const fs::path &modelPath = fs::path(),
         const size_t batchSize = 5000,
         const int64_t duration = 100000,
         const double floatThreshold = 0.8,
-        const std::string &device = "cuda:0"
+        const std::string &device = "cuda:0",
+        const Utils::SurfaceLayout layout = Utils::SurfaceLayout::Columns
     );
 
     /// @brief Initialize the filter
@@ -124,10 +138,38 @@ public:
         return evaluate(event);
     }
 
+    /// @brief Process a range of events
+    /// @param out Cleared, then filled with the events classified as signal in input order; its capacity is reused across calls
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief Process a vector of events
     /// @param events Input events to process
     /// @return Vector of events classified as signal
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief Classify a vector of events without compacting them
+    /// @param events Input events to process
+    /// @return One entry per input event, 1 if classified as signal
+    std::vector<uint8_t> classify_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief Sensor width.
+    inline int width() const noexcept {
+        return mWidth;
+    }
+
+    /// @brief Sensor height.
+    inline int height() const noexcept {
+        return mHeight;
+    }
+
+    /// @brief Save the filter state to a binary snapshot.
+    /// @param path Snapshot file path.
+    void save_state(const std::string &path) const;
+
+    /// @brief Restore the filter state from a snapshot written by save_state.
+    /// @param path Snapshot file path.
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
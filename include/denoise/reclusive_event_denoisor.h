@@ -17,8 +17,11 @@
 #define SHIMETA_SDK_ALGORITHM_DENOISE_RECLUSIVE_EVENT_DENOISOR_H
 
 #include <vector>
+#include <string>
 #include <metavision/sdk/base/events/event_cd.h>
 
+#include "utils/pixel_surface.h"
+
 namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
@@ -31,8 +34,8 @@ private:
     int height_;
     int tau_;      // 时间常数，单位us
     int n_;        // 空间邻域半径
-    std::vector<std::vector<int64_t>> last_event_time_on_;
-    std::vector<std::vector<int64_t>> last_event_time_off_;
+    Utils::PixelSurface<int64_t> last_event_time_on_;
+    Utils::PixelSurface<int64_t> last_event_time_off_;
 
 public:
     /// @brief 构造函数
@@ -40,7 +43,24 @@ public:
     /// @param height 传感器高度
     /// @param tau 时间常数
     /// @param n 空间邻域半径
-    ReclusiveEventDenoisor(int width, int height, int tau, int n);
+    /// @param layout 逐像素时间表面的内存布局
+    ReclusiveEventDenoisor(int width, int height, int tau, int n,
+                           Utils::SurfaceLayout layout = Utils::SurfaceLayout::Columns);
+
+    /// @brief 判断单个事件是否为信号，并更新该像素的最后事件时间
+    /// @param event 输入事件
+    /// @return true为信号，false为噪声
+    bool evaluate(const Metavision::EventCD &event);
+
+    /// @brief 处理单个事件
+    inline bool retain(const Metavision::EventCD &event) noexcept {
+        return evaluate(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
 
     /// @brief 处理一批事件，返回去噪后的事件
     /// @param events 输入事件
@@ -49,6 +69,24 @@ public:
 
     /// @brief 重置内部状态
     void reset();
+
+    /// @brief 传感器宽度
+    inline int width() const noexcept {
+        return width_;
+    }
+
+    /// @brief 传感器高度
+    inline int height() const noexcept {
+        return height_;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_DENOISE_REFRACTORY_FILTER_H
+#define SHIMETA_SDK_ALGORITHM_DENOISE_REFRACTORY_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+/// @brief Per-pixel refractory period and burst limiting stage.
+/// @details 强边缘过后，部分传感器会在几微秒内对同一像素连续输出多个事件，只增加下游负载而不增加信息。
+/// 该滤波器对每个像素施加两条约束：距上一个保留事件不足 deadTime 的事件被剔除（不延长死区）；
+/// 可选的令牌桶按 maxRate 补充令牌、容量为 burstSize，每个保留事件消耗一个令牌。
+/// 每个像素只有一个 32 位状态字：高 24 位为上一个保留事件的相对时刻（微秒），低 8 位为 1/16 精度的令牌数；
+/// 不足 1/16 令牌的补充余量通过把该时刻提前计入下次补充，因此限速时死区最多缩短 1e6 / (16 * maxRate) 微秒。
+/// 时间基准每隔约 8 秒平移一次。被剔除的事件不写状态，适合放在任意滤波链的最前端。
+class RefractoryFilter {
+private:
+    int mWidth;
+    int mHeight;
+    int64_t mDeadTime;  // us
+    double mMaxRate;    // events/s，0 表示不限速
+    int mBurstSize;
+
+    uint32_t mDeadTicks;
+    uint64_t mRefillQ32;    // 每微秒补充的 1/16 令牌数，Q32 定点
+    uint32_t mCapacity;     // 令牌桶容量，1/16 令牌
+    std::vector<uint32_t> mState;
+    int64_t mBase;
+    bool mHasBase;
+    uint64_t mProcessed;
+    uint64_t mRejected;
+
+    /// @brief 平移时间基准，使 t 落在 24 位相对时间范围内
+    void rebase(int64_t t);
+
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param deadTime 每像素死区时间（微秒），0 表示不设死区
+    /// @param maxRate 每像素平均事件率上限（事件/秒），0 表示不限速
+    /// @param burstSize 令牌桶容量，即允许的突发事件数（1~15）
+    RefractoryFilter(
+        int width,
+        int height,
+        int64_t deadTime = 100,
+        double maxRate = 0.0,
+        int burstSize = 4
+    );
+
+    /// @brief 清空全部像素状态与统计
+    void initialize();
+
+    /// @brief 判断单个事件是否为信号
+    /// @param event 输入事件，同一像素内时间戳需单调不减
+    /// @return true为信号，false为被限流的事件
+    bool evaluate(const Metavision::EventCD &event);
+
+    /// @brief 处理单个事件
+    inline bool retain(const Metavision::EventCD &event) {
+        return evaluate(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
+    /// @brief 批量处理事件
+    /// @param events 输入事件向量
+    /// @return 保留的事件向量
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 自 initialize 以来被剔除的事件比例
+    inline double rejectionRatio() const noexcept {
+        return mProcessed > 0 ? static_cast<double>(mRejected) / static_cast<double>(mProcessed) : 0.0;
+    }
+
+    /// @brief 传感器宽度
+    inline int width() const noexcept {
+        return mWidth;
+    }
+
+    /// @brief 传感器高度
+    inline int height() const noexcept {
+        return mHeight;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
+};
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_DENOISE_REFRACTORY_FILTER_H
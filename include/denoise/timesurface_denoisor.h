@@ -18,10 +18,13 @@
 
 #include <vector>
 #include <cmath>
+#include <string>
 #include <metavision/sdk/base/events/event_cd.h>
 #include <metavision/sdk/base/events/event_cd_vector.h>
 #include <metavision/sdk/base/events/event2d.h>
 
+#include "utils/pixel_surface.h"
+
 namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
@@ -37,8 +40,8 @@ private:
     double mFloatThreshold;
 
     // 记录正负极性事件的时间表面
-    std::vector<std::vector<int64_t>> mPos;
-    std::vector<std::vector<int64_t>> mNeg;
+    Utils::PixelSurface<int64_t> mPos;
+    Utils::PixelSurface<int64_t> mNeg;
 
 public:
     /// @brief 构造函数
@@ -47,7 +50,9 @@ public:
     /// @param decay 时间衰减常数（微秒）
     /// @param searchRadius 搜索半径
     /// @param floatThreshold 判定阈值
-    TimeSurfaceDenoisor(int width, int height, double decay = 20000, size_t searchRadius = 1, double floatThreshold = 0.2);
+    /// @param layout 时间表面的内存布局
+    TimeSurfaceDenoisor(int width, int height, double decay = 20000, size_t searchRadius = 1, double floatThreshold = 0.2,
+                        Utils::SurfaceLayout layout = Utils::SurfaceLayout::Columns);
 
     /// @brief 初始化表面
     void initialize();
@@ -64,10 +69,33 @@ public:
         return evaluate(event);
     }
 
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief 批量处理事件
     /// @param events 输入事件向量
     /// @return 去噪后的事件向量
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 传感器宽度
+    inline int width() const noexcept {
+        return mWidth;
+    }
+
+    /// @brief 传感器高度
+    inline int height() const noexcept {
+        return mHeight;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
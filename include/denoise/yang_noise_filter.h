@@ -19,16 +19,23 @@
 #include <vector>
 #include <cmath>
 #include <deque>
+#include <string>
 
 #include <metavision/sdk/base/events/event_cd.h>
 #include <metavision/sdk/base/events/event2d.h>
 
+#include "utils/pixel_surface.h"
+
 namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
 
 /// @brief Yang Noise Filter for CD events.
 /// @details This filter uses a spatio-temporal density approach to classify events as real or noise.
+/// With @p useSlidingWindow enabled, the density is read from incrementally maintained per-polarity
+/// column counts instead of scanning the (2r+1)^2 neighborhood, so a query costs O(r). The result is
+/// identical to the brute-force scan as long as event timestamps are non-decreasing.
+/// Both modes treat p > 0 as ON and any other polarity (0 or -1) as OFF.
 class YangNoiseFilter {
 private:
     int16_t mWidth;
@@ -36,9 +43,23 @@ private:
     int64_t mDuration;
     size_t mSearchRadius;
     size_t mIntThreshold;
+    bool mUseSlidingWindow;
+
+    Utils::PixelSurface<int64_t> mLastTimestamps;
+    Utils::PixelSurface<uint8_t> mLastPolarities;
+
+    // Sliding-window state: mColumnCounts[(p * H + y) * W + x] is the number of active pixels of
+    // polarity p in column x, rows [y - r, y + r]. A pixel is active while t - lastTimestamp <= duration.
+    std::vector<uint16_t> mColumnCounts;
+    std::vector<uint8_t> mActive;
+    std::deque<Metavision::EventCD> mWindowEvents;
+    bool mSeedPending;
 
-    std::vector<std::vector<int64_t>> mLastTimestamps;
-    std::vector<std::vector<uint8_t>> mLastPolarities;
+    /// @brief Add or remove one active pixel from the column counts of the given polarity.
+    void updateColumnCounts(int16_t x, int16_t y, uint8_t polarity, int delta);
+
+    /// @brief Deactivate every pixel whose last event is older than @p now - duration.
+    void expire(int64_t now);
 
 public:
     /// @brief Constructor
@@ -47,12 +68,16 @@ public:
     /// @param duration Time window duration in microseconds.
     /// @param searchRadius Maximum L1 distance for spatio-temporal search.
     /// @param intThreshold Minimum number of nearby events to classify an event as real.
+    /// @param useSlidingWindow Use O(r) incremental counting instead of the O(r^2) scan, recommended for searchRadius >= 3.
+    /// @param layout Memory layout of the per-pixel timestamp and polarity surfaces.
     explicit YangNoiseFilter(
         const int16_t width,
         const int16_t height,
         const int64_t duration = 10000,
         const size_t searchRadius = 1,
-        const size_t intThreshold = 2
+        const size_t intThreshold = 2,
+        const bool useSlidingWindow = false,
+        const Utils::SurfaceLayout layout = Utils::SurfaceLayout::Columns
     );
 
     /// @brief Initialize the filter.
@@ -75,10 +100,33 @@ public:
         return evaluate(event);
     }
 
+    /// @brief Process a range of events.
+    /// @param out Cleared, then filled with the retained events in input order; its capacity is reused across calls.
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
     /// @brief Process a vector of events.
     /// @param events The vector of events to process.
     /// @return A vector containing only the retained events.
     std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief Sensor width.
+    inline int width() const noexcept {
+        return mWidth;
+    }
+
+    /// @brief Sensor height.
+    inline int height() const noexcept {
+        return mHeight;
+    }
+
+    /// @brief Save the filter state to a binary snapshot.
+    /// @param path Snapshot file path.
+    void save_state(const std::string &path) const;
+
+    /// @brief Restore the filter state from a snapshot written by save_state.
+    /// @param path Snapshot file path.
+    void load_state(const std::string &path);
 };
 
 } // namespace Denoise
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_RESTORATION_ANTI_FLICKER_FILTER_H
+#define SHIMETA_SDK_ALGORITHM_RESTORATION_ANTI_FLICKER_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Restoration {
+
+/// @brief Anti-flicker stage rejecting events from periodic lighting.
+/// @details 荧光灯与 LED 在 100/120 Hz 下闪烁，使像素周期性地交替产生正、负极性事件。
+/// 该滤波器为每个像素（或 blockSize x blockSize 的块）记录最近一次由负到正的极性翻转时刻与周期，
+/// 周期落在 [1/maxFrequency, 1/minFrequency] 内且与上一周期相差不超过 periodTolerance 时累加计数，
+/// 周期过长则清零，过短视为突发内的噪声翻转而忽略。计数达到 minCycles 且最近一次翻转未超过两个最长周期的单元，
+/// 其事件全部剔除。每个单元只有 8 字节状态，每事件一次读写，适合放在滤波链的最前端。
+class AntiFlickerFilter {
+private:
+    /// @brief 单元状态
+    struct Cell {
+        uint32_t onset;  // 最近一次负到正翻转的时刻（低 32 位，微秒）
+        uint16_t period; // 最近一次翻转周期（微秒，饱和）
+        uint8_t flags;   // bit0：最近事件为正极性，bit1：onset 有效
+        uint8_t cycles;  // 连续落在频段内的周期数（饱和）
+    };
+
+    int mWidth;
+    int mHeight;
+    int mBlockSize;
+    double mMinFrequency;
+    double mMaxFrequency;
+    int64_t mPeriodTolerance;
+    uint8_t mMinCycles;
+
+    uint32_t mMinPeriod;
+    uint32_t mMaxPeriod;
+    int mGridWidth;
+    std::vector<Cell> mCells;
+    uint64_t mProcessed;
+    uint64_t mRejected;
+
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param minFrequency 频段下限（Hz）
+    /// @param maxFrequency 频段上限（Hz）
+    /// @param periodTolerance 相邻两个周期的最大差值（微秒）
+    /// @param minCycles 判为闪烁所需的连续周期数
+    /// @param blockSize 共享状态的方块边长，1 表示逐像素
+    AntiFlickerFilter(
+        int width,
+        int height,
+        double minFrequency = 90.0,
+        double maxFrequency = 130.0,
+        int64_t periodTolerance = 1000,
+        int minCycles = 3,
+        int blockSize = 1
+    );
+
+    /// @brief 清空全部单元状态与统计
+    void initialize();
+
+    /// @brief 判断单个事件是否为信号
+    /// @param event 输入事件，同一单元内时间戳需单调不减
+    /// @return true为信号，false为闪烁事件
+    bool evaluate(const Metavision::EventCD &event);
+
+    /// @brief 处理单个事件
+    inline bool retain(const Metavision::EventCD &event) {
+        return evaluate(event);
+    }
+
+    /// @brief 批量处理事件
+    /// @param out 清空后按输入顺序写入保留的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out);
+
+    /// @brief 批量处理事件
+    /// @param events 输入事件向量
+    /// @return 保留的事件向量
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 查询像素当前是否被判为闪烁
+    /// @param t 当前时刻
+    bool isFlickering(int x, int y, int64_t t) const noexcept;
+
+    /// @brief 自 initialize 以来被剔除的事件比例
+    inline double rejectionRatio() const noexcept {
+        return mProcessed > 0 ? static_cast<double>(mRejected) / static_cast<double>(mProcessed) : 0.0;
+    }
+
+    /// @brief 将滤波器状态保存为二进制快照
+    /// @param path 快照文件路径
+    void save_state(const std::string &path) const;
+
+    /// @brief 从 save_state 写出的快照恢复滤波器状态
+    /// @param path 快照文件路径
+    void load_state(const std::string &path);
+};
+
+} // namespace Restoration
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_RESTORATION_ANTI_FLICKER_FILTER_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_RESTORATION_COMPLEMENTARY_FILTER_H
+#define SHIMETA_SDK_ALGORITHM_RESTORATION_COMPLEMENTARY_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+#include "utils/event_partitioner.h"
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Restoration {
+
+/// @brief Per-pixel complementary filter for high-rate intensity reconstruction.
+/// @details 每个像素维护对数亮度 L，事件使 L 增加正/负对比度阈值；两次更新之间 L 以截止频率 alpha 指数衰减到
+/// APS 帧的对数亮度 L_F（未提供 APS 帧时 L_F = 0，即高通滤波）。衰减是惰性的：每个像素只记录最近更新时刻，
+/// 事件只更新被触发的像素，读出帧时再对全部像素统一补上衰减。读出与 APS 融合是定长的连续内存循环，
+/// 其中指数函数用多项式近似实现，可被编译器自动向量化，并按行在线程池上并行。
+/// 时间戳以 32 位相对值保存，必要时平移基准。
+class ComplementaryFilter {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param cutoffFrequency 截止频率 alpha（弧度/秒）
+    /// @param contrastPositive 正极性事件的对比度阈值（对数亮度）
+    /// @param contrastNegative 负极性事件的对比度阈值（对数亮度）
+    /// @param threads 线程数，0 表示硬件并发数，1 表示单线程
+    ComplementaryFilter(
+        int width,
+        int height,
+        float cutoffFrequency = 5.0f,
+        float contrastPositive = 0.1f,
+        float contrastNegative = 0.1f,
+        size_t threads = 0
+    );
+
+    /// @brief 清空亮度与 APS 帧
+    void initialize();
+
+    /// @brief 积分事件，只更新被触发的像素
+    /// @details 事件需按时间排序，且不早于之前的事件与 APS 帧。
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 积分事件
+    void process_events(const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 融合 APS 帧
+    /// @details 先把每个像素的 L 衰减到 t，再以 log(1 + I) 作为新的衰减目标。
+    /// @param frame 8 位灰度帧，大小 height*width
+    /// @param t 帧的曝光时刻
+    void setFrame(const uint8_t *frame, Metavision::timestamp t);
+
+    /// @brief 读出 t 时刻的对数亮度
+    /// @param out 大小 height*width
+    void logFrame(Metavision::timestamp t, float *out);
+
+    /// @brief 读出 t 时刻的 8 位图像，对数亮度在 [logMin, logMax] 内线性映射到 [0, 255]
+    /// @details 未融合 APS 帧时 L 在 0 附近，可取正负若干个对比度阈值；融合 APS 帧时可取 [0, log(256)]。
+    /// @param out 大小 height*width
+    void frame(Metavision::timestamp t, uint8_t *out, float logMin, float logMax);
+
+private:
+    int mWidth;
+    int mHeight;
+    size_t mPixels;
+    float mAlpha;
+    float mContrastPositive;
+    float mContrastNegative;
+
+    std::unique_ptr<Utils::WorkStealingPool> mPool;
+    Utils::EventPartitioner mPartitioner;
+    bool mHasBase;
+    Metavision::timestamp mBase;
+    std::vector<float> mLog;       // L
+    std::vector<float> mTarget;    // L_F
+    std::vector<int32_t> mTime;    // 最近更新时刻，相对 mBase（微秒）
+    float mFrameLog[256];          // log(1 + I)
+
+    /// @brief 保证 t 相对基准不超过 32 位范围
+    void rebase(Metavision::timestamp t);
+
+    /// @brief 按行带并行执行 body(first, last)，参数为像素下标范围
+    template <typename Body>
+    void forEachRows(const Body &body);
+};
+
+} // namespace Restoration
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_RESTORATION_COMPLEMENTARY_FILTER_H
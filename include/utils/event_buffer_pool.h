@@ -0,0 +1,129 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_EVENT_BUFFER_POOL_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_EVENT_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Pool of recycled, capacity-retaining event buffers.
+/// @details 相机回调每批都构造并释放输入、输出向量，每秒数千次 malloc/free。池中的缓冲区归还时只清空内容、保留容量，
+/// 再次取出即可直接写入，预热之后的稳态路径上没有分配。acquire() 返回的 Handle 独占一个缓冲区，
+/// 析构（或调用 release()）时自动归还，可以移动到其他线程由消费者归还；池本身是线程安全的。
+/// 池的生命周期需长于它发出的全部 Handle。
+class EventBufferPool {
+public:
+    using Buffer = std::vector<Metavision::EventCD>;
+
+    /// @brief 独占一个池中缓冲区的句柄，只能移动
+    class Handle {
+    public:
+        Handle() noexcept = default;
+        Handle(Handle &&other) noexcept;
+        Handle &operator=(Handle &&other) noexcept;
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+
+        /// @brief 析构时把缓冲区归还给池
+        ~Handle();
+
+        inline Buffer &operator*() const noexcept {
+            return *mBuffer;
+        }
+
+        inline Buffer *operator->() const noexcept {
+            return mBuffer;
+        }
+
+        inline Buffer *get() const noexcept {
+            return mBuffer;
+        }
+
+        inline explicit operator bool() const noexcept {
+            return mBuffer != nullptr;
+        }
+
+        /// @brief 提前归还缓冲区，之后句柄为空
+        void release();
+
+    private:
+        friend class EventBufferPool;
+
+        Handle(EventBufferPool *pool, Buffer *buffer) noexcept;
+
+        EventBufferPool *mPool = nullptr;
+        Buffer *mBuffer = nullptr;
+        size_t mCapacity = 0; // 取出时的容量，用于统计扩容
+    };
+
+    /// @brief 池的统计量
+    struct Stats {
+        size_t buffers;         // 池拥有的缓冲区数
+        size_t inUse;           // 当前被取出的缓冲区数
+        size_t highWaterMark;   // 同时取出的缓冲区数的最大值
+        size_t largestCapacity; // 归还过的缓冲区的最大容量（事件数）
+        uint64_t acquisitions;  // 累计取出次数
+        uint64_t allocations;   // 新建缓冲区与缓冲区扩容的累计次数，稳态下不再增长
+    };
+
+    /// @brief 构造函数
+    /// @param buffers 预先创建的缓冲区数
+    /// @param capacity 每个预建缓冲区预留的容量（事件数）
+    explicit EventBufferPool(size_t buffers = 0, size_t capacity = 0);
+
+    EventBufferPool(const EventBufferPool &) = delete;
+    EventBufferPool &operator=(const EventBufferPool &) = delete;
+
+    /// @brief 取出一个空缓冲区，池中没有空闲缓冲区时新建一个
+    Handle acquire();
+
+    /// @brief 取出一个缓冲区并复制 [begin, end) 的事件
+    Handle acquire(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 当前统计量
+    Stats stats() const;
+
+    /// @brief 释放全部空闲缓冲区的内存，被取出的缓冲区不受影响
+    void trim();
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<std::unique_ptr<Buffer>> mBuffers;
+    std::vector<Buffer *> mFree; // 容量不小于 mBuffers.size()，归还时不会分配
+    size_t mInUse;
+    size_t mHighWaterMark;
+    size_t mLargestCapacity;
+    uint64_t mAcquisitions;
+    uint64_t mAllocations;
+
+    /// @brief 归还缓冲区
+    void recycle(Buffer *buffer, size_t capacity);
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_EVENT_BUFFER_POOL_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_EVENT_MERGER_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_EVENT_MERGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Streaming k-way timestamp merge of time-sorted event sources.
+/// @details 用败者树归并 N 路各自按时间排序的事件源，每个输出事件只需 log2(N) 次比较，不做全量排序。
+/// 时间戳相同的事件按源编号排序，结果是确定的。每路源可设置坐标偏移（例如把两路相机拼接到同一画布）。
+/// 在线归并时每路源有自己的水位线，表示该源之后不会再出现更早的事件：push 一批事件后水位线推进到批内最后一个时间戳，
+/// 空闲的源可用 advance 单独推进，关闭的源不再限制水位线。只有早于全部打开源最小水位线的事件才会输出，
+/// 输出写入固定容量的缓冲区，写满或一轮归并结束时调用回调，缓冲区随后被复用。
+/// 该类不是线程安全的，多个采集线程需要在外部串行化 push。
+class EventMerger {
+public:
+    /// @brief 输出回调，[begin, end) 在回调返回后失效
+    using OutputCallback = std::function<void(const Metavision::EventCD *begin, const Metavision::EventCD *end)>;
+
+    /// @brief 一路已排序的事件区间
+    struct Range {
+        const Metavision::EventCD *begin;
+        const Metavision::EventCD *end;
+    };
+
+    /// @brief 坐标偏移，加到输出事件的 x、y 上
+    struct Offset {
+        int dx = 0;
+        int dy = 0;
+    };
+
+    /// @brief 构造函数
+    /// @param sources 事件源数量
+    /// @param bufferSize 输出缓冲区容量（事件数）
+    /// @param output 输出回调
+    explicit EventMerger(size_t sources, size_t bufferSize = 8192, OutputCallback output = nullptr);
+
+    /// @brief 设置输出回调
+    void setOutputCallback(OutputCallback output);
+
+    /// @brief 设置事件源的坐标偏移
+    void setOffset(size_t source, int dx, int dy);
+
+    /// @brief 追加一路源的一批事件并输出水位线之前的事件
+    /// @details 批内事件需按时间排序，且不早于该源之前的水位线，否则抛出 std::invalid_argument。事件被复制到内部缓冲区。
+    void push(size_t source, const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 追加一路源的一批事件
+    void push(size_t source, const std::vector<Metavision::EventCD> &events);
+
+    /// @brief 推进一路源的水位线，表示该源不会再产生早于 watermark 的事件
+    void advance(size_t source, Metavision::timestamp watermark);
+
+    /// @brief 关闭一路源，其剩余事件参与归并，之后不再限制水位线
+    void close(size_t source);
+
+    /// @brief 关闭全部源并输出所有剩余事件
+    void finish();
+
+    /// @brief 丢弃未输出的事件并重新打开全部源，坐标偏移保留
+    void reset();
+
+    /// @brief 全部打开源的最小水位线；早于它的事件都已输出
+    Metavision::timestamp watermark() const noexcept;
+
+    /// @brief 已缓冲、尚未输出的事件数
+    size_t pending() const noexcept;
+
+    /// @brief 一次性归并若干已排序的区间，不复制输入
+    /// @param ranges 各路事件区间
+    /// @param out 清空后写入归并结果，容量在多次调用间复用
+    /// @param offsets 各路坐标偏移，为空表示不偏移
+    static void merge(const std::vector<Range> &ranges, std::vector<Metavision::EventCD> &out,
+                      const std::vector<Offset> &offsets = {});
+
+private:
+    struct Source {
+        std::vector<Metavision::EventCD> buffer;
+        const Metavision::EventCD *head = nullptr;
+        const Metavision::EventCD *tail = nullptr;
+        Metavision::timestamp watermark;
+        bool closed = false;
+        Offset offset;
+    };
+
+    size_t mBufferSize;
+    OutputCallback mOutput;
+    std::vector<Source> mSources;
+    std::vector<Metavision::timestamp> mKeys; // 各源队首时间戳，末尾为哨兵
+    std::vector<uint32_t> mTree;              // 败者树，mTree[0] 为胜者
+    std::vector<Metavision::EventCD> mBuffer;
+
+    /// @brief 源 a 的队首是否先于源 b
+    inline bool before(uint32_t a, uint32_t b) const noexcept {
+        return mKeys[a] < mKeys[b] || (mKeys[a] == mKeys[b] && a < b);
+    }
+
+    /// @brief 源 source 的队首变化后，从叶子到根重赛
+    void replay(uint32_t source);
+
+    /// @brief 重建败者树
+    void rebuild();
+
+    /// @brief 依次输出早于 limit 的事件到 dst，最多 capacity 个
+    /// @return 输出的事件数
+    size_t drain(Metavision::timestamp limit, Metavision::EventCD *dst, size_t capacity);
+
+    /// @brief 输出水位线之前的全部事件
+    void emit();
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_EVENT_MERGER_H
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_EVENT_PARTITIONER_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_EVENT_PARTITIONER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief 按行带划分事件，用于无锁并行的逐像素累积。
+/// @details 传感器按行切分为若干行带，事件按所在行带稳定重排（保留带内原始顺序）。
+/// 同一像素的事件总落在同一行带内，因此各行带可以并行写各自的行而无需加锁，结果与串行处理完全一致。
+/// 计数与重排两步也在线程池上分块并行；事件被复制到按行带连续存放的内部缓冲区（多次调用间复用），
+/// 使后续逐带处理是顺序访存。
+class EventPartitioner {
+public:
+    /// @brief 构造函数
+    /// @param height 传感器高度
+    /// @param bands 行带数量，会被限制在 [1, height]
+    EventPartitioner(int height, size_t bands);
+
+    /// @brief 将 [begin, end) 中的事件按行带重排
+    /// @param pool 线程池，为 nullptr 时串行执行
+    /// @param keepIndices 为 true 时同时记录事件在输入中的下标，见 bandIndices()
+    void partition(const Metavision::EventCD *begin, const Metavision::EventCD *end, WorkStealingPool *pool,
+                   bool keepIndices = false);
+
+    /// @brief 按行带并行处理事件，每个事件调用一次 body(band, event)
+    /// @details 同一行带内按原始顺序调用；事件数较少或没有线程池时直接串行遍历。
+    template <typename Body>
+    void forEach(const Metavision::EventCD *begin, const Metavision::EventCD *end, WorkStealingPool *pool,
+                 const Body &body) {
+        const size_t count = static_cast<size_t>(end - begin);
+        if (pool == nullptr || mBands == 1 || count < kParallelThreshold) {
+            for (const Metavision::EventCD *event = begin; event != end; ++event) {
+                body(static_cast<size_t>(mRowBand[event->y]), *event);
+            }
+            return;
+        }
+        partition(begin, end, pool);
+        pool->parallelFor(0, mBands, [&](size_t first, size_t last) {
+            for (size_t band = first; band < last; ++band) {
+                for (size_t i = mBandOffsets[band]; i < mBandOffsets[band + 1]; ++i) {
+                    body(band, mOrdered[i]);
+                }
+            }
+        }, 1);
+    }
+
+    /// @brief 在 partition 之后分偶数、奇数行带两轮并行执行 body(band)
+    /// @details 同一轮内的行带互不相邻，只要邻域半径不超过行带高度，读写邻域的逐事件处理就不会产生数据竞争，
+    /// 且结果与线程数无关。
+    /// @param pool 线程池，为 nullptr 时串行执行
+    void forEachBandAlternating(WorkStealingPool *pool, const std::function<void(size_t)> &body);
+
+    /// @brief 最矮行带的行数
+    int minBandRows() const noexcept;
+
+    /// @brief 行带数量
+    inline size_t bandCount() const noexcept {
+        return mBands;
+    }
+
+    /// @brief 行带的起始行（包含）
+    inline int bandBegin(size_t band) const noexcept {
+        return mBandRows[band];
+    }
+
+    /// @brief 行带的结束行（不包含）
+    inline int bandEnd(size_t band) const noexcept {
+        return mBandRows[band + 1];
+    }
+
+    /// @brief 最近一次 partition 后行带内的事件
+    inline const Metavision::EventCD *bandEvents(size_t band) const noexcept {
+        return mOrdered.data() + mBandOffsets[band];
+    }
+
+    /// @brief 最近一次 partition(..., true) 后行带内事件在输入中的下标
+    inline const uint32_t *bandIndices(size_t band) const noexcept {
+        return mIndices.data() + mBandOffsets[band];
+    }
+
+    /// @brief 最近一次 partition 后行带内的事件数
+    inline size_t bandSize(size_t band) const noexcept {
+        return mBandOffsets[band + 1] - mBandOffsets[band];
+    }
+
+    /// @brief 少于该事件数时不值得并行
+    static constexpr size_t kParallelThreshold = 1 << 14;
+
+private:
+    size_t mBands;
+    std::vector<uint16_t> mRowBand;    // 行 -> 行带
+    std::vector<int> mBandRows;        // 行带边界，大小 mBands + 1
+    std::vector<size_t> mChunkCounts;  // [chunk][band] 计数，随后变为写入偏移
+    std::vector<size_t> mBandOffsets;  // 大小 mBands + 1
+    std::vector<Metavision::EventCD> mOrdered; // 按行带重排后的事件
+    std::vector<uint32_t> mIndices;            // 重排后事件在输入中的下标
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_EVENT_PARTITIONER_H
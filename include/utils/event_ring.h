@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_EVENT_RING_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_EVENT_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Lock-free single-producer single-consumer ring of event batches.
+/// @details 把相机回调（SDK 解码线程）与滤波解耦：回调只把事件批次复制进预分配的槽位，滤波在消费者线程上进行，
+/// 慢速滤波不再阻塞解码、造成驱动侧丢包。全部槽位在构造时一次分配，push 与 pop 只读写两个原子计数器，
+/// 不加锁、不分配内存；超过单个槽位容量的批次按顺序占用多个槽位。剩余槽位不足以容纳整个批次时，
+/// push 丢弃整个批次并计入溢出统计，从不阻塞生产者。消费者没有数据时先短暂自旋再休眠，
+/// 生产者只在消费者休眠时才获取互斥量唤醒它。只允许一个线程 push、一个线程 pop / consume。
+class EventRing {
+public:
+    /// @brief 环形缓冲区的统计量
+    struct Stats {
+        uint64_t pushedBatches;  // 成功写入的批次数
+        uint64_t pushedEvents;   // 成功写入的事件数
+        uint64_t droppedBatches; // 因溢出被丢弃的批次数
+        uint64_t droppedEvents;  // 因溢出被丢弃的事件数
+        size_t occupied;         // 当前被占用的槽位数
+        size_t highWaterMark;    // 被占用槽位数的最大值
+    };
+
+    /// @brief 构造函数
+    /// @param slots 槽位数
+    /// @param slotCapacity 每个槽位的事件容量
+    explicit EventRing(size_t slots = 32, size_t slotCapacity = 16384);
+
+    EventRing(const EventRing &) = delete;
+    EventRing &operator=(const EventRing &) = delete;
+
+    /// @brief 写入一批事件，仅生产者线程调用
+    /// @return 剩余槽位不足、整个批次被丢弃或环已关闭时返回 false
+    bool push(const Metavision::EventCD *begin, const Metavision::EventCD *end);
+
+    /// @brief 取出最早的一个槽位并调用 consumer(begin, end)，仅消费者线程调用
+    /// @details 事件指针只在回调期间有效，回调返回后槽位才交还给生产者。
+    /// @return 环为空时返回 false
+    template <typename Consumer>
+    bool pop(Consumer &&consumer) {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const size_t slot = head % mSlots;
+        const Metavision::EventCD *events = mEvents.data() + slot * mSlotCapacity;
+        consumer(events, events + mSizes[slot]);
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief 消费者线程的主循环：逐个取出槽位交给 consumer，没有数据时休眠，close() 之后取完剩余槽位再返回
+    template <typename Consumer>
+    void consume(Consumer &&consumer) {
+        for (;;) {
+            if (pop(consumer)) {
+                continue;
+            }
+            if (mClosed.load(std::memory_order_acquire)) {
+                // 关闭前写入的批次此时都已可见
+                while (pop(consumer)) {
+                }
+                return;
+            }
+            waitForData(std::chrono::milliseconds(10));
+        }
+    }
+
+    /// @brief 等待直到环非空、环已关闭或超时，仅消费者线程调用
+    void waitForData(std::chrono::microseconds timeout);
+
+    /// @brief 关闭环并唤醒消费者，之后的 push 都返回 false；仅生产者线程或生产者停止之后调用
+    void close();
+
+    /// @brief 清空槽位与统计量并重新打开，调用时生产者与消费者都需已停止
+    void reset();
+
+    /// @brief 环是否已关闭
+    inline bool closed() const noexcept {
+        return mClosed.load(std::memory_order_acquire);
+    }
+
+    /// @brief 当前被占用的槽位数
+    inline size_t size() const noexcept {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+    /// @brief 槽位数
+    inline size_t slotCount() const noexcept {
+        return mSlots;
+    }
+
+    /// @brief 每个槽位的事件容量
+    inline size_t slotCapacity() const noexcept {
+        return mSlotCapacity;
+    }
+
+    /// @brief 当前统计量，可从任意线程调用
+    Stats stats() const;
+
+private:
+    size_t mSlots;
+    size_t mSlotCapacity;
+    std::vector<Metavision::EventCD> mEvents; // [slots][slotCapacity]
+    std::vector<size_t> mSizes;               // 每个槽位中的事件数
+
+    // 生产者与消费者各自写入的计数器分属不同缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> mTail;
+    alignas(64) std::atomic<size_t> mHead;
+
+    alignas(64) std::atomic<bool> mClosed;
+    std::atomic<bool> mSleeping;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+
+    std::atomic<uint64_t> mPushedBatches;
+    std::atomic<uint64_t> mPushedEvents;
+    std::atomic<uint64_t> mDroppedBatches;
+    std::atomic<uint64_t> mDroppedEvents;
+    std::atomic<size_t> mHighWaterMark;
+
+    /// @brief 消费者休眠时唤醒它
+    void notify();
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_EVENT_RING_H
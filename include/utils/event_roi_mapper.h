@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_EVENT_ROI_MAPPER_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_EVENT_ROI_MAPPER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Region-of-interest crop and spatial binning pre-stage.
+/// @details 只保留落在一个或多个感兴趣区域（ROI）内的事件，并可按 2x2 / 4x4 合并像素，把坐标重映射到缩小后的画布上。
+/// 多个 ROI 按给定顺序从左到右紧密排列，画布宽度为各 ROI 合并后宽度之和，高度为其中的最大值；
+/// 后续滤波器按 outputWidth() / outputHeight() 构造，逐像素状态与邻域扫描的代价随之缩小。
+/// 合并只重映射坐标，同一块内的多个事件都会输出（时间戳与极性不变），需要时可在其后接 RefractoryFilter 限制事件率。
+/// ROI 互相重叠时，落在重叠处的事件在每个包含它的 ROI 中各输出一次。
+class EventRoiMapper {
+public:
+    /// @brief 传感器坐标下的矩形区域
+    struct Roi {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param rois 感兴趣区域，需完全位于传感器内；为空时使用整个传感器
+    /// @param binning 像素合并倍数，1、2 或 4
+    EventRoiMapper(int width, int height, const std::vector<Roi> &rois = {}, int binning = 1);
+
+    /// @brief 缩小后画布的宽度，用于构造后续滤波器
+    inline int outputWidth() const noexcept {
+        return mOutputWidth;
+    }
+
+    /// @brief 缩小后画布的高度，用于构造后续滤波器
+    inline int outputHeight() const noexcept {
+        return mOutputHeight;
+    }
+
+    /// @brief 第 roi 个区域在画布上占据的矩形
+    Roi outputRegion(size_t roi) const;
+
+    /// @brief 区域数量
+    inline size_t roiCount() const noexcept {
+        return mRegions.size();
+    }
+
+    /// @brief 裁剪并重映射一批事件
+    /// @param out 清空后按输入顺序写入重映射后的事件，容量在多次调用间复用
+    void process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                        std::vector<Metavision::EventCD> &out) const;
+
+    /// @brief 裁剪并重映射一批事件
+    /// @param events 输入事件向量
+    /// @return 重映射后的事件
+    std::vector<Metavision::EventCD> process_events(const std::vector<Metavision::EventCD> &events) const;
+
+    /// @brief 把画布坐标映射回传感器坐标（合并块的左上角像素），用于把检测、跟踪结果还原到全分辨率
+    /// @return 坐标不在任何区域内时返回 false
+    bool toSensor(int x, int y, int &sensorX, int &sensorY) const noexcept;
+
+private:
+    /// @brief 区域的传感器位置与画布上的横向偏移
+    struct Region {
+        int x;
+        int y;
+        uint32_t width;
+        uint32_t height;
+        int outputX;
+        int outputWidth;
+        int outputHeight;
+    };
+
+    int mShift;
+    int mOutputWidth;
+    int mOutputHeight;
+    bool mDisjoint;
+    std::vector<Region> mRegions;
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_EVENT_ROI_MAPPER_H
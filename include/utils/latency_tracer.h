@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_LATENCY_TRACER_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_LATENCY_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/utils/timestamp.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Fixed-size log-linear latency histogram.
+/// @details 纳秒值小于 64 时逐值计数，之后每个二进制数量级分 32 个桶，相对误差约 3%，上限约 18 分钟。
+/// 记录是常数时间的数组自增，不分配内存；不是线程安全的。
+class LatencyHistogram {
+public:
+    /// @brief 记录一个延迟（纳秒），负值按 0 记录
+    void record(int64_t nanoseconds) noexcept;
+
+    /// @brief 分位数（纳秒），q 取 [0, 1]，返回所在桶的上界且不超过最大值；没有记录时返回 0
+    int64_t percentile(double q) const noexcept;
+
+    /// @brief 合并另一个直方图
+    void merge(const LatencyHistogram &other) noexcept;
+
+    /// @brief 清空
+    void reset() noexcept;
+
+    inline uint64_t count() const noexcept {
+        return mCount;
+    }
+
+    inline int64_t max() const noexcept {
+        return mMax;
+    }
+
+private:
+    static constexpr int kLinear = 64;
+    static constexpr int kSubBuckets = 32;
+    static constexpr int kMaxExponent = 40;
+    static constexpr size_t kBuckets = kLinear + (kMaxExponent - 6 + 1) * kSubBuckets;
+
+    std::array<uint64_t, kBuckets> mBuckets{};
+    uint64_t mCount = 0;
+    int64_t mMax = 0;
+
+    static size_t bucketOf(uint64_t value) noexcept;
+    static int64_t upperBound(size_t bucket) noexcept;
+};
+
+/// @brief Per-batch latency tracing from sensor timestamp to output.
+/// @details 每个批次到达时记录墙钟时间（steady_clock）与批次最后一个事件的传感器时间戳，
+/// 传感器时间到墙钟的偏移取迄今所有批次“到达时刻 - 传感器时间”的最小值，即传输最快的批次；
+/// 每级处理结束时记录出口时间。各级耗时（自上一级出口或到达起）与端到端延迟（最后出口时刻 - 按偏移换算的传感器时刻）
+/// 分别累积到直方图中，可导出 p50 / p99 / p999。端到端延迟以最快批次为基准，刚启动时偏移尚未收敛，
+/// 可在预热后调用 reset() 重新统计。关闭时 arrive() 只读一个原子标志，返回的 Trace 不活跃，
+/// stage() / finish() 内联判断后直接返回。Trace 是值类型，可随批次在线程间传递；统计量的更新由互斥量保护，每批一次。
+class LatencyTracer {
+public:
+    /// @brief 一个批次的跟踪记录
+    struct Trace {
+        Metavision::timestamp sensorTime = 0; // 批次最后一个事件的传感器时间（微秒）
+        int64_t arrival = 0;                  // 到达时的墙钟时间（纳秒）
+        int64_t last = 0;                     // 上一级出口的墙钟时间（纳秒）
+        bool active = false;
+    };
+
+    /// @brief 分位数摘要（微秒）
+    struct Summary {
+        std::string name;
+        uint64_t count;
+        double p50;
+        double p99;
+        double p999;
+        double max;
+    };
+
+    /// @brief 构造函数
+    /// @param stages 各级名称，按处理顺序排列
+    /// @param enabled 是否启用跟踪
+    explicit LatencyTracer(std::vector<std::string> stages, bool enabled = true);
+
+    /// @brief 启用或关闭跟踪，可从任意线程调用
+    inline void setEnabled(bool enabled) noexcept {
+        mEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    inline bool enabled() const noexcept {
+        return mEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// @brief 批次到达
+    /// @param sensorTime 批次最后一个事件的时间戳
+    inline Trace arrive(Metavision::timestamp sensorTime) {
+        return enabled() ? start(sensorTime) : Trace{};
+    }
+
+    /// @brief 第 index 级处理结束
+    inline void stage(Trace &trace, size_t index) {
+        if (trace.active) {
+            recordStage(trace, index);
+        }
+    }
+
+    /// @brief 批次输出，记录端到端延迟并结束跟踪
+    inline void finish(Trace &trace) {
+        if (trace.active) {
+            recordEnd(trace);
+        }
+    }
+
+    /// @brief 第 index 级耗时的分位数
+    Summary stageSummary(size_t index) const;
+
+    /// @brief 端到端延迟的分位数
+    Summary endToEndSummary() const;
+
+    /// @brief 当前的传感器时间到墙钟偏移（纳秒），尚无批次时返回 0
+    int64_t sensorOffset() const;
+
+    /// @brief 导出各级与端到端的分位数到 CSV 文件
+    /// @details 列为 stage, count, p50_us, p99_us, p999_us, max_us，最后一行为 end_to_end。
+    void exportCsv(const std::string &path) const;
+
+    /// @brief 清空统计量与偏移
+    void reset();
+
+    inline size_t stageCount() const noexcept {
+        return mStageNames.size();
+    }
+
+    /// @brief 当前墙钟时间（纳秒）
+    static inline int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    std::vector<std::string> mStageNames;
+    std::atomic<bool> mEnabled;
+
+    mutable std::mutex mMutex;
+    std::vector<LatencyHistogram> mStages;
+    LatencyHistogram mEndToEnd;
+    int64_t mOffset;
+    bool mHasOffset;
+
+    Trace start(Metavision::timestamp sensorTime);
+    void recordStage(Trace &trace, size_t index);
+    void recordEnd(Trace &trace);
+    static Summary summarize(const std::string &name, const LatencyHistogram &histogram);
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_LATENCY_TRACER_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_MULTI_STREAM_EXECUTOR_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_MULTI_STREAM_EXECUTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+#include "utils/work_stealing_pool.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Multi-stream executor on a shared work-stealing pool.
+/// @details 每路事件流拥有自己的滤波器状态和批次队列，所有流的批次在同一个工作窃取线程池上调度。
+/// 同一路流任意时刻最多只有一个任务在执行，因此批次按提交顺序处理、输出回调按顺序调用；
+/// 每个任务最多连续处理 quantum 个批次后让出线程，保证各流之间的公平性。
+class MultiStreamExecutor {
+public:
+    /// @brief 单路流的处理函数
+    using Stage = std::function<std::vector<Metavision::EventCD>(const std::vector<Metavision::EventCD> &)>;
+
+    /// @brief 输出回调，在工作线程中按批次顺序调用
+    using OutputCallback = std::function<void(size_t stream, std::vector<Metavision::EventCD> &&events)>;
+
+    /// @brief 单路流的统计量
+    struct StreamMetrics {
+        size_t submittedBatches;
+        size_t processedBatches;
+        size_t queueDepth;
+        size_t maxQueueDepth;
+        uint64_t inputEvents;
+        uint64_t outputEvents;
+        double busyTime;       // 处理耗时（微秒）
+        double processingRate; // 每秒处理耗时内的输入事件数
+        double throughput;     // 自首个批次提交以来的输入事件率（事件/秒）
+    };
+
+    /// @brief 构造函数
+    /// @param threads 工作线程数，0 表示使用硬件并发数
+    /// @param quantum 每个调度任务最多连续处理的批次数
+    explicit MultiStreamExecutor(size_t threads = 0, size_t quantum = 4);
+
+    /// @brief 等待所有队列处理完毕
+    ~MultiStreamExecutor();
+
+    /// @brief 添加一路流，处理函数由调用者提供
+    /// @note 需在开始提交批次之前添加所有流
+    /// @return 流编号
+    size_t addStream(Stage stage, OutputCallback output);
+
+    /// @brief 添加一路流，执行器接管滤波器对象（任意提供 process_events 的去噪类）
+    /// @return 流编号
+    template <typename Filter>
+    size_t addFilterStream(Filter filter, OutputCallback output) {
+        auto owned = std::make_shared<Filter>(std::move(filter));
+        return addStream([owned](const std::vector<Metavision::EventCD> &events) {
+            return owned->process_events(events);
+        }, std::move(output));
+    }
+
+    /// @brief 提交一批事件，可从任意线程调用
+    /// @param stream 流编号
+    /// @param events 事件批次
+    void submit(size_t stream, std::vector<Metavision::EventCD> events);
+
+    /// @brief 阻塞直到所有已提交批次处理完毕
+    void flush();
+
+    /// @brief 获取单路流的统计量
+    StreamMetrics metrics(size_t stream) const;
+
+    inline size_t streamCount() const noexcept {
+        return mStreams.size();
+    }
+
+private:
+    struct Stream {
+        size_t id;
+        Stage stage;
+        OutputCallback output;
+
+        mutable std::mutex mutex;
+        std::deque<std::vector<Metavision::EventCD>> queue;
+        bool scheduled = false;
+        StreamMetrics metrics{};
+        std::chrono::steady_clock::time_point firstSubmit;
+    };
+
+    size_t mQuantum;
+    std::vector<std::unique_ptr<Stream>> mStreams;
+    WorkStealingPool mPool;
+
+    /// @brief 处理一路流的最多 quantum 个批次，仍有积压时重新入队
+    void runStream(Stream &stream);
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_MULTI_STREAM_EXECUTOR_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_PIXEL_SURFACE_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_PIXEL_SURFACE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief 逐像素表面的内存布局
+enum class SurfaceLayout {
+    Columns, ///< 按列连续存放（x 为外层），与原先 [x][y] 的嵌套向量相同
+    Rows,    ///< 按行连续存放（y 为外层）
+    Tiled,   ///< 8x8 分块，块内按行、块间按行存放
+    Morton   ///< Z 序（Morton）曲线，宽高补齐到 2 的幂
+};
+
+/// @brief Maps pixel coordinates to storage offsets for a given surface layout.
+/// @details 四种布局的偏移都可以拆成 offset(x, y) = column[x] + row[y]，两张表在构造时生成，
+/// 查找时只有两次表查询与一次加法，没有按布局的分支。Morton 布局按 2 的幂补齐，
+/// 存储元素数可能大于 width * height。
+class SurfaceIndex {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param layout 内存布局
+    SurfaceIndex(int width, int height, SurfaceLayout layout);
+
+    /// @brief 像素 (x, y) 的存储偏移
+    inline size_t operator()(int x, int y) const noexcept {
+        return static_cast<size_t>(mColumn[x]) + mRow[y];
+    }
+
+    /// @brief 列偏移表，长度为 width
+    inline const uint32_t *columnOffsets() const noexcept {
+        return mColumn.data();
+    }
+
+    /// @brief 行偏移表，长度为 height
+    inline const uint32_t *rowOffsets() const noexcept {
+        return mRow.data();
+    }
+
+    /// @brief 存储所需的元素数（含补齐）
+    inline size_t size() const noexcept {
+        return mSize;
+    }
+
+    inline int width() const noexcept {
+        return static_cast<int>(mColumn.size());
+    }
+
+    inline int height() const noexcept {
+        return static_cast<int>(mRow.size());
+    }
+
+    inline SurfaceLayout layout() const noexcept {
+        return mLayout;
+    }
+
+private:
+    SurfaceLayout mLayout;
+    std::vector<uint32_t> mColumn;
+    std::vector<uint32_t> mRow;
+    size_t mSize;
+};
+
+/// @brief Per-pixel state surface with a selectable memory layout.
+/// @details 邻域查询每个事件要访问 2r+1 行（或列），布局决定这些访问落在多少条缓存行和页上。
+/// 快照统一按列优先顺序导出，与布局无关，不同布局之间可以互相加载。
+template <typename T>
+class PixelSurface {
+public:
+    /// @brief 构造函数
+    /// @param width 传感器宽度
+    /// @param height 传感器高度
+    /// @param layout 内存布局
+    /// @param value 初始值
+    PixelSurface(int width, int height, SurfaceLayout layout = SurfaceLayout::Columns, const T &value = T()) :
+        mIndex(width, height, layout),
+        mData(mIndex.size(), value) {}
+
+    /// @brief 将所有像素置为 value
+    void fill(const T &value) {
+        std::fill(mData.begin(), mData.end(), value);
+    }
+
+    inline T &operator()(int x, int y) noexcept {
+        return mData[mIndex(x, y)];
+    }
+
+    inline const T &operator()(int x, int y) const noexcept {
+        return mData[mIndex(x, y)];
+    }
+
+    inline const SurfaceIndex &index() const noexcept {
+        return mIndex;
+    }
+
+    inline T *data() noexcept {
+        return mData.data();
+    }
+
+    inline const T *data() const noexcept {
+        return mData.data();
+    }
+
+    /// @brief 按列优先顺序导出 width * height 个像素，用于快照
+    std::vector<T> columns() const {
+        std::vector<T> flat;
+        flat.reserve(static_cast<size_t>(mIndex.width()) * mIndex.height());
+        for (int x = 0; x < mIndex.width(); ++x) {
+            for (int y = 0; y < mIndex.height(); ++y) {
+                flat.push_back((*this)(x, y));
+            }
+        }
+        return flat;
+    }
+
+    /// @brief 从列优先顺序的像素恢复表面，尺寸不符时抛出 std::invalid_argument
+    void assignColumns(const std::vector<T> &flat) {
+        if (flat.size() != static_cast<size_t>(mIndex.width()) * mIndex.height()) {
+            throw std::invalid_argument("PixelSurface: surface size does not match geometry");
+        }
+        const T *value = flat.data();
+        for (int x = 0; x < mIndex.width(); ++x) {
+            for (int y = 0; y < mIndex.height(); ++y) {
+                (*this)(x, y) = *value++;
+            }
+        }
+    }
+
+private:
+    SurfaceIndex mIndex;
+    std::vector<T> mData;
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_PIXEL_SURFACE_H
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_STATE_SNAPSHOT_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_STATE_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief 由四个字符生成滤波器标识
+constexpr uint32_t stateTag(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) | (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+/// @brief Binary writer for filter state snapshots.
+/// @details 快照由文件头和若干段组成，每段记录元素大小、元素个数和原始数据，并按 8 字节对齐，
+/// 以便 StateReader 通过内存映射直接读取。只支持平凡可复制的元素类型。
+class StateWriter {
+public:
+    /// @brief 创建快照文件
+    /// @param path 文件路径
+    /// @param tag 滤波器标识
+    /// @param version 状态格式版本
+    StateWriter(const std::string &path, uint32_t tag, uint32_t version = 1);
+
+    /// @brief 写入一段连续数据
+    template <typename T>
+    void write(const T *data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "state elements must be trivially copyable");
+        writeSection(data, sizeof(T), count);
+    }
+
+    template <typename T>
+    void write(const std::vector<T> &values) {
+        write(values.data(), values.size());
+    }
+
+    template <typename T>
+    void write(const std::deque<T> &values) {
+        write(std::vector<T>(values.begin(), values.end()));
+    }
+
+    /// @brief 写入按列存储的二维表面，保存为一段 width * height 的数据
+    template <typename T>
+    void write(const std::vector<std::vector<T>> &columns) {
+        std::vector<T> flat;
+        flat.reserve(columns.empty() ? 0 : columns.size() * columns.front().size());
+        for (const auto &column : columns) {
+            flat.insert(flat.end(), column.begin(), column.end());
+        }
+        write(flat);
+    }
+
+    /// @brief 写入单个数值
+    template <typename T>
+    void writeValue(const T &value) {
+        write(&value, 1);
+    }
+
+    /// @brief 写完所有段后关闭文件并检查错误
+    void close();
+
+private:
+    std::ofstream mFile;
+    std::string mPath;
+
+    void writeSection(const void *data, size_t elementSize, size_t count);
+};
+
+/// @brief Memory-mapped reader for filter state snapshots.
+/// @details 以只读方式映射快照文件，按写入顺序逐段读取。文件头、滤波器标识、版本或元素大小不匹配时抛出异常。
+class StateReader {
+public:
+    /// @brief 映射快照文件并校验文件头
+    /// @param path 文件路径
+    /// @param tag 期望的滤波器标识
+    /// @param version 期望的状态格式版本
+    StateReader(const std::string &path, uint32_t tag, uint32_t version = 1);
+    ~StateReader();
+
+    StateReader(const StateReader &) = delete;
+    StateReader &operator=(const StateReader &) = delete;
+
+    /// @brief 读取下一段数据，返回指向映射内存的指针
+    /// @param elementSize 期望的元素大小
+    /// @param count 输出元素个数
+    const void *next(size_t elementSize, size_t &count);
+
+    template <typename T>
+    void read(std::vector<T> &values) {
+        size_t count = 0;
+        const T *data = static_cast<const T *>(next(sizeof(T), count));
+        values.assign(data, data + count);
+    }
+
+    template <typename T>
+    void read(std::deque<T> &values) {
+        size_t count = 0;
+        const T *data = static_cast<const T *>(next(sizeof(T), count));
+        values.assign(data, data + count);
+    }
+
+    /// @brief 读取按列存储的二维表面，要求尺寸与当前表面一致
+    template <typename T>
+    void read(std::vector<std::vector<T>> &columns) {
+        size_t count = 0;
+        const T *data = static_cast<const T *>(next(sizeof(T), count));
+        const size_t height = columns.empty() ? 0 : columns.front().size();
+        if (count != columns.size() * height) {
+            throw std::invalid_argument("State surface size does not match filter geometry: " + mPath);
+        }
+        for (auto &column : columns) {
+            std::memcpy(column.data(), data, height * sizeof(T));
+            data += height;
+        }
+    }
+
+    template <typename T>
+    T readValue() {
+        size_t count = 0;
+        const void *data = next(sizeof(T), count);
+        if (count != 1) {
+            throw std::runtime_error("Unexpected state value: " + mPath);
+        }
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    /// @brief 读取单个数值并要求与期望值相同，用于校验尺寸等参数
+    template <typename T>
+    void expectValue(const T &expected, const char *name) {
+        if (readValue<T>() != expected) {
+            throw std::invalid_argument(std::string("State ") + name + " does not match filter: " + mPath);
+        }
+    }
+
+private:
+    std::string mPath;
+    const uint8_t *mData;
+    size_t mSize;
+    size_t mOffset;
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_STATE_SNAPSHOT_H
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SHIMETA_SDK_ALGORITHM_UTILS_WORK_STEALING_POOL_H
+#define SHIMETA_SDK_ALGORITHM_UTILS_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+/// @brief Work-stealing thread pool.
+/// @details 每个工作线程拥有自己的任务队列，从队首取任务；本地队列为空时从其他线程的队尾窃取任务。
+/// 工作线程内提交的任务进入本线程队列，外部提交的任务轮流分配到各队列。
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /// @brief 构造函数
+    /// @param threads 工作线程数，0 表示使用硬件并发数
+    explicit WorkStealingPool(size_t threads = 0);
+
+    /// @brief 等待全部任务完成后停止工作线程
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /// @brief 提交任务
+    void submit(Task task);
+
+    /// @brief 将 [begin, end) 划分为若干块并行执行，阻塞直到全部完成
+    /// @details 调用线程在等待期间也会执行队列中的任务，因此可以在工作线程内嵌套调用。
+    /// @param begin 起始索引
+    /// @param end 结束索引
+    /// @param body 处理 [chunkBegin, chunkEnd) 的函数
+    /// @param grain 每块最少元素数，0 表示按线程数均分
+    void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)> &body, size_t grain = 0);
+
+    /// @brief 阻塞直到所有已提交任务执行完毕
+    void wait();
+
+    /// @brief 工作线程数
+    inline size_t threadCount() const noexcept {
+        return mThreads.size();
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mSleepMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+    std::atomic<size_t> mQueued;
+    std::atomic<size_t> mUnfinished;
+    std::atomic<size_t> mNextQueue;
+    bool mStop;
+
+    /// @brief 工作线程主循环
+    void workerLoop(size_t index);
+
+    /// @brief 先从 home 队列队首取任务，失败则从其他队列队尾窃取
+    bool tryPop(size_t home, Task &task);
+
+    /// @brief 执行任务并更新未完成计数
+    void execute(Task &task);
+};
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
+
+#endif // SHIMETA_SDK_ALGORITHM_UTILS_WORK_STEALING_POOL_H
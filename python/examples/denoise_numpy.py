@@ -0,0 +1,58 @@
+"""
+Denoise NumPy event arrays with the HVAlgo Python bindings and report throughput.
+
+Build the bindings with `cmake -DBUILD_PYTHON=ON ..` and add `<build>/python` to PYTHONPATH.
+"""
+import time
+
+import numpy as np
+
+import hv_algo
+
+
+def random_events(count, width, height, seed=0):
+    """Synthetic time-sorted events in the Metavision EventCD layout"""
+    rng = np.random.default_rng(seed)
+    events = np.empty(count, dtype=hv_algo.denoise.EVENT_CD_DTYPE)
+    events["x"] = rng.integers(0, width, count)
+    events["y"] = rng.integers(0, height, count)
+    events["p"] = rng.integers(0, 2, count)
+    events["t"] = np.cumsum(rng.integers(0, 2, count))
+    return events
+
+
+def main(input_path="", width=1280, height=720, count=5000000):
+    """Run every denoiser on the same events
+    Args:
+        input_path: optional .npy file with a structured array (x, y, p, t)
+        width: sensor width
+        height: sensor height
+        count: number of synthetic events when no input is given
+    """
+    events = np.load(input_path) if input_path else random_events(count, width, height)
+    print("events: ", len(events))
+
+    filters = {
+        "yang": hv_algo.denoise.YangNoiseFilter(width, height, 10000, 1, 2),
+        "yang_sliding_r3": hv_algo.denoise.YangNoiseFilter(width, height, 10000, 3, 2, True),
+        "khodamoradi": hv_algo.denoise.KhodamoradiDenoiser(width, height),
+        "red": hv_algo.denoise.ReclusiveEventDenoisor(width, height, 10000, 1),
+        "time_surface": hv_algo.denoise.TimeSurfaceDenoisor(width, height),
+        "hot_pixel": hv_algo.denoise.HotPixelFilter(width, height),
+    }
+    for name, denoiser in filters.items():
+        start = time.perf_counter()
+        mask = denoiser.process_mask(events)
+        elapsed = time.perf_counter() - start
+        print("%-16s kept %6.2f%%  %7.2f Mev/s" % (name, 100.0 * mask.mean(), len(events) / elapsed * 1e-6))
+
+    # separate columns, e.g. loaded from another format
+    denoiser = hv_algo.denoise.YangNoiseFilter(width, height)
+    mask = denoiser.process_mask_columns(events["x"], events["y"], events["p"], events["t"])
+    kept = events[mask]
+    print("columns: kept ", len(kept))
+
+
+if __name__ == "__main__":
+    import fire
+    fire.Fire(main)
@@ -0,0 +1,354 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+#include "denoise/double_window_filter.h"
+#include "denoise/event_flow_filter.h"
+#include "denoise/hot_pixel_filter.h"
+#include "denoise/khodamoradi_denoiser.h"
+#include "denoise/reclusive_event_denoisor.h"
+#include "denoise/refractory_filter.h"
+#include "denoise/timesurface_denoisor.h"
+#include "denoise/yang_noise_filter.h"
+#include "utils/pixel_surface.h"
+#ifdef ENABLE_TORCH
+#include "denoise/multi_layer_perceptron_filter.h"
+#endif
+
+namespace py = pybind11;
+using namespace Shimeta::Algorithm::Denoise;
+using Shimeta::Algorithm::Utils::SurfaceLayout;
+
+namespace {
+
+// 读取任意整数类型的一列（结构化数组字段或独立数组），不复制数据
+struct Column {
+    const char *data;
+    py::ssize_t stride;
+    char kind;
+    py::ssize_t size;
+
+    inline int64_t get(py::ssize_t i) const noexcept {
+        const char *ptr = data + i * stride;
+        switch (size) {
+        case 1:
+            return kind == 'u' ? static_cast<int64_t>(*reinterpret_cast<const uint8_t *>(ptr)) : *reinterpret_cast<const int8_t *>(ptr);
+        case 2:
+            return kind == 'u' ? static_cast<int64_t>(*reinterpret_cast<const uint16_t *>(ptr)) : *reinterpret_cast<const int16_t *>(ptr);
+        case 4:
+            return kind == 'u' ? static_cast<int64_t>(*reinterpret_cast<const uint32_t *>(ptr)) : *reinterpret_cast<const int32_t *>(ptr);
+        default:
+            return *reinterpret_cast<const int64_t *>(ptr);
+        }
+    }
+};
+
+Column makeColumn(const py::array &array, py::ssize_t offset, const py::dtype &dtype, const char *name) {
+    const char kind = dtype.kind();
+    const py::ssize_t size = dtype.itemsize();
+    if ((kind != 'i' && kind != 'u' && kind != 'b') || (size != 1 && size != 2 && size != 4 && size != 8)) {
+        throw std::invalid_argument(std::string("Field '") + name + "' must be an integer type");
+    }
+    if (array.ndim() != 1) {
+        throw std::invalid_argument("Event arrays must be one-dimensional");
+    }
+    return {static_cast<const char *>(array.data()) + offset, array.strides(0), kind == 'b' ? 'u' : kind, size};
+}
+
+// 一批事件的只读视图，支持结构化数组 (x, y, p, t) 或四个独立列
+struct EventView {
+    py::ssize_t count = 0;
+    const Metavision::EventCD *packed = nullptr; // 与 Metavision::EventCD 内存布局一致时直接使用
+    Column x{}, y{}, p{}, t{};
+
+    // 极性统一为 {0, 1}：NumPy 数据常用 {-1, 1}，而滤波器按极性索引逐像素状态
+    inline Metavision::EventCD at(py::ssize_t i) const noexcept {
+        if (packed) {
+            Metavision::EventCD event = packed[i];
+            event.p = event.p > 0 ? 1 : 0;
+            return event;
+        }
+        return Metavision::EventCD(static_cast<unsigned short>(x.get(i)), static_cast<unsigned short>(y.get(i)),
+                                   static_cast<short>(p.get(i) > 0 ? 1 : 0), static_cast<Metavision::timestamp>(t.get(i)));
+    }
+};
+
+EventView viewStructured(const py::array &events) {
+    const py::dtype dtype = events.dtype();
+    if (!py::hasattr(dtype, "fields") || dtype.attr("fields").is_none()) {
+        throw std::invalid_argument("Expected a structured array with fields x, y, p, t");
+    }
+    const py::dict fields = dtype.attr("fields");
+    EventView view;
+    view.count = events.size();
+    auto field = [&](const char *name) {
+        if (!fields.contains(name)) {
+            throw std::invalid_argument(std::string("Structured array has no field '") + name + "'");
+        }
+        const py::tuple info = fields[name];
+        return makeColumn(events, info[1].cast<py::ssize_t>(), info[0].cast<py::dtype>(), name);
+    };
+    view.x = field("x");
+    view.y = field("y");
+    view.p = field("p");
+    view.t = field("t");
+
+    // Metavision 的 numpy 事件格式 (u2, u2, i2, i8) 与 EventCD 布局相同，连续存储时可直接按指针访问
+    const char *base = static_cast<const char *>(events.data());
+    auto at = [base](const Column &column, size_t offset) {
+        return column.data - base == static_cast<py::ssize_t>(offset);
+    };
+    const bool packed = dtype.itemsize() == static_cast<py::ssize_t>(sizeof(Metavision::EventCD)) &&
+                        events.strides(0) == static_cast<py::ssize_t>(sizeof(Metavision::EventCD)) &&
+                        at(view.x, offsetof(Metavision::EventCD, x)) && view.x.kind == 'u' && view.x.size == 2 &&
+                        at(view.y, offsetof(Metavision::EventCD, y)) && view.y.kind == 'u' && view.y.size == 2 &&
+                        at(view.p, offsetof(Metavision::EventCD, p)) && view.p.kind == 'i' && view.p.size == 2 &&
+                        at(view.t, offsetof(Metavision::EventCD, t)) && view.t.kind == 'i' && view.t.size == 8;
+    if (packed) {
+        view.packed = static_cast<const Metavision::EventCD *>(events.data());
+    }
+    return view;
+}
+
+EventView viewColumns(const py::array &x, const py::array &y, const py::array &p, const py::array &t) {
+    if (x.size() != y.size() || x.size() != p.size() || x.size() != t.size()) {
+        throw std::invalid_argument("Columns x, y, p, t must have the same length");
+    }
+    EventView view;
+    view.count = x.size();
+    view.x = makeColumn(x, 0, x.dtype(), "x");
+    view.y = makeColumn(y, 0, y.dtype(), "y");
+    view.p = makeColumn(p, 0, p.dtype(), "p");
+    view.t = makeColumn(t, 0, t.dtype(), "t");
+    return view;
+}
+
+// 有传感器尺寸的滤波器在处理前检查坐标，越界事件会写出逐像素状态之外的内存
+void checkBounds(const EventView &view, int width, int height) {
+    for (py::ssize_t i = 0; i < view.count; ++i) {
+        const int64_t x = view.x.get(i);
+        const int64_t y = view.y.get(i);
+        if (x < 0 || x >= width || y < 0 || y >= height) {
+            throw std::invalid_argument("Event " + std::to_string(i) + " at (" + std::to_string(x) + ", " +
+                                        std::to_string(y) + ") lies outside the " + std::to_string(width) + "x" +
+                                        std::to_string(height) + " sensor");
+        }
+    }
+}
+
+template <typename Filter>
+auto checkGeometry(const Filter &filter, const EventView &view, int) -> decltype(filter.width(), void()) {
+    checkBounds(view, filter.width(), filter.height());
+}
+
+// 没有逐像素状态的滤波器（DWF、EventFlow）接受任意坐标
+template <typename Filter>
+void checkGeometry(const Filter &, const EventView &, long) {}
+
+// 逐事件调用滤波器，结果写入布尔掩码；过滤期间释放 GIL
+template <typename Filter, typename Evaluate>
+py::array_t<bool> evaluateMask(Filter &filter, const EventView &view, Evaluate evaluate) {
+    py::array_t<bool> mask(view.count);
+    bool *out = mask.mutable_data();
+    {
+        py::gil_scoped_release release;
+        for (py::ssize_t i = 0; i < view.count; ++i) {
+            out[i] = evaluate(filter, view.at(i));
+        }
+    }
+    return mask;
+}
+
+// 按掩码压缩结构化数组，返回与输入相同 dtype 的新数组
+py::array compact(const py::array &events, const py::array_t<bool> &mask) {
+    const bool *keep = mask.data();
+    py::ssize_t kept = 0;
+    for (py::ssize_t i = 0; i < mask.size(); ++i) {
+        kept += keep[i];
+    }
+    py::array output(events.dtype(), {kept});
+    const py::ssize_t itemsize = events.itemsize();
+    const py::ssize_t stride = events.strides(0);
+    const char *src = static_cast<const char *>(events.data());
+    char *dst = static_cast<char *>(output.mutable_data());
+    {
+        py::gil_scoped_release release;
+        for (py::ssize_t i = 0; i < mask.size(); ++i) {
+            if (keep[i]) {
+                std::memcpy(dst, src + i * stride, itemsize);
+                dst += itemsize;
+            }
+        }
+    }
+    return output;
+}
+
+// 为滤波器类绑定统一的 numpy 接口，classify 将一批事件视图转换为布尔掩码
+template <typename Filter, typename Classify>
+void bindMaskApi(py::class_<Filter> &cls, Classify classify) {
+    auto mask = [classify](Filter &self, const EventView &view) {
+        checkGeometry(self, view, 0);
+        return classify(self, view);
+    };
+    cls.def("process_mask", [mask](Filter &self, const py::array &events) {
+            return mask(self, viewStructured(events));
+        }, py::arg("events"),
+        "Classify a structured event array (x, y, p, t) and return a boolean mask of retained events.")
+        .def("process_mask_columns", [mask](Filter &self, const py::array &x, const py::array &y, const py::array &p, const py::array &t) {
+            return mask(self, viewColumns(x, y, p, t));
+        }, py::arg("x"), py::arg("y"), py::arg("p"), py::arg("t"),
+        "Classify events given as separate columns and return a boolean mask of retained events.")
+        .def("process_events", [mask](Filter &self, const py::array &events) {
+            return compact(events, mask(self, viewStructured(events)));
+        }, py::arg("events"),
+        "Classify a structured event array and return the retained events with the same dtype.")
+        .def("save_state", &Filter::save_state, py::arg("path"))
+        .def("load_state", &Filter::load_state, py::arg("path"));
+}
+
+// 逐事件滤波器的 numpy 接口
+template <typename Filter, typename Evaluate>
+void bindNumpy(py::class_<Filter> &cls, Evaluate evaluate) {
+    bindMaskApi(cls, [evaluate](Filter &self, const EventView &view) {
+        return evaluateMask(self, view, evaluate);
+    });
+}
+
+template <typename Filter>
+bool retainEvent(Filter &filter, const Metavision::EventCD &event) {
+    return filter.retain(event);
+}
+
+} // namespace
+
+PYBIND11_MODULE(hv_algo, m) {
+    m.doc() = "HVAlgo event camera algorithms";
+    py::module_ denoise = m.def_submodule("denoise", "Denoising algorithm module");
+
+    // Metavision 的 numpy 事件格式，按此 dtype 连续存储的数组走零拷贝快速路径
+    py::list eventFields;
+    eventFields.append(py::make_tuple("x", "<u2"));
+    eventFields.append(py::make_tuple("y", "<u2"));
+    eventFields.append(py::make_tuple("p", "<i2"));
+    eventFields.append(py::make_tuple("t", "<i8"));
+    denoise.attr("EVENT_CD_DTYPE") = py::module_::import("numpy").attr("dtype")(eventFields);
+
+    // 邻域类滤波器的逐像素表面布局
+    py::enum_<SurfaceLayout>(denoise, "SurfaceLayout")
+        .value("Columns", SurfaceLayout::Columns)
+        .value("Rows", SurfaceLayout::Rows)
+        .value("Tiled", SurfaceLayout::Tiled)
+        .value("Morton", SurfaceLayout::Morton);
+
+    py::class_<DoubleWindowFilter> dwf(denoise, "DoubleWindowFilter");
+    dwf.def(py::init<size_t, size_t, size_t>(), py::arg("bufferSize") = 36, py::arg("searchRadius") = 9, py::arg("intThreshold") = 1)
+        .def("initialize", &DoubleWindowFilter::initialize);
+    bindNumpy(dwf, retainEvent<DoubleWindowFilter>);
+
+    py::class_<EventFlowFilter> eff(denoise, "EventFlowFilter");
+    eff.def(py::init<size_t, size_t, double, int64_t>(), py::arg("bufferSize") = 100, py::arg("searchRadius") = 1,
+            py::arg("floatThreshold") = 20.0, py::arg("duration") = 2000)
+        .def("initialize", &EventFlowFilter::initialize);
+    bindNumpy(eff, retainEvent<EventFlowFilter>);
+
+    py::class_<HotPixelFilter> hpf(denoise, "HotPixelFilter");
+    hpf.def(py::init<int, int, double, double, int64_t, bool>(), py::arg("width"), py::arg("height"),
+            py::arg("hotRateThreshold") = 1000.0, py::arg("deadRateThreshold") = 0.0,
+            py::arg("learningDuration") = 1000000, py::arg("continuousLearning") = false)
+        .def("initialize", &HotPixelFilter::initialize)
+        .def("update_mask", &HotPixelFilter::updateMask, py::arg("duration"))
+        .def("is_masked", &HotPixelFilter::isMasked, py::arg("x"), py::arg("y"))
+        .def("set_masked", &HotPixelFilter::setMasked, py::arg("x"), py::arg("y"), py::arg("masked"))
+        .def("save_mask", &HotPixelFilter::saveMask, py::arg("path"))
+        .def("load_mask", &HotPixelFilter::loadMask, py::arg("path"))
+        .def_property_readonly("hot_pixel_count", &HotPixelFilter::hotPixelCount)
+        .def_property_readonly("dead_pixel_count", &HotPixelFilter::deadPixelCount);
+    bindNumpy(hpf, retainEvent<HotPixelFilter>);
+
+    py::class_<KhodamoradiDenoiser> khd(denoise, "KhodamoradiDenoiser");
+    khd.def(py::init<uint16_t, uint16_t, Metavision::timestamp, size_t>(), py::arg("width"), py::arg("height"),
+            py::arg("duration") = 2000, py::arg("int_threshold") = 2)
+        .def("initialize", &KhodamoradiDenoiser::initialize);
+    bindNumpy(khd, [](KhodamoradiDenoiser &filter, const Metavision::EventCD &event) {
+        return filter.filter(event);
+    });
+
+    py::class_<ReclusiveEventDenoisor> red(denoise, "ReclusiveEventDenoisor");
+    red.def(py::init<int, int, int, int, SurfaceLayout>(), py::arg("width"), py::arg("height"), py::arg("tau"), py::arg("n"),
+            py::arg("layout") = SurfaceLayout::Columns)
+        .def("reset", &ReclusiveEventDenoisor::reset);
+    bindNumpy(red, retainEvent<ReclusiveEventDenoisor>);
+
+    py::class_<RefractoryFilter> rff(denoise, "RefractoryFilter");
+    rff.def(py::init<int, int, int64_t, double, int>(), py::arg("width"), py::arg("height"), py::arg("deadTime") = 100,
+            py::arg("maxRate") = 0.0, py::arg("burstSize") = 4)
+        .def("initialize", &RefractoryFilter::initialize)
+        .def_property_readonly("rejection_ratio", &RefractoryFilter::rejectionRatio);
+    bindNumpy(rff, retainEvent<RefractoryFilter>);
+
+    py::class_<TimeSurfaceDenoisor> tsd(denoise, "TimeSurfaceDenoisor");
+    tsd.def(py::init<int, int, double, size_t, double, SurfaceLayout>(), py::arg("width"), py::arg("height"),
+            py::arg("decay") = 20000.0, py::arg("searchRadius") = 1, py::arg("floatThreshold") = 0.2,
+            py::arg("layout") = SurfaceLayout::Columns)
+        .def("initialize", &TimeSurfaceDenoisor::initialize);
+    bindNumpy(tsd, retainEvent<TimeSurfaceDenoisor>);
+
+    py::class_<YangNoiseFilter> ynf(denoise, "YangNoiseFilter");
+    ynf.def(py::init<int16_t, int16_t, int64_t, size_t, size_t, bool, SurfaceLayout>(), py::arg("width"),
+            py::arg("height"), py::arg("duration") = 10000, py::arg("searchRadius") = 1, py::arg("intThreshold") = 2,
+            py::arg("useSlidingWindow") = false, py::arg("layout") = SurfaceLayout::Columns)
+        .def("initialize", &YangNoiseFilter::initialize);
+    bindNumpy(ynf, retainEvent<YangNoiseFilter>);
+
+#ifdef ENABLE_TORCH
+    // MLP 滤波器按批推理，先将事件整理为 EventCD 向量再整批分类
+    py::class_<MultiLayerPerceptronFilter> mlpf(denoise, "MultiLayerPerceptronFilter");
+    mlpf.def(py::init([](int width, int height, const std::string &modelPath, size_t batchSize, int64_t duration,
+                         double floatThreshold, const std::string &device, SurfaceLayout layout) {
+                 return new MultiLayerPerceptronFilter({width, height}, modelPath, batchSize, duration, floatThreshold, device,
+                                                       layout);
+             }), py::arg("width"), py::arg("height"), py::arg("modelPath"), py::arg("batchSize") = 5000,
+             py::arg("duration") = 100000, py::arg("floatThreshold") = 0.8, py::arg("device") = "cuda:0",
+             py::arg("layout") = SurfaceLayout::Columns)
+        .def("initialize", &MultiLayerPerceptronFilter::initialize);
+    bindMaskApi(mlpf, [](MultiLayerPerceptronFilter &self, const EventView &view) {
+        py::array_t<bool> mask(view.count);
+        bool *out = mask.mutable_data();
+        {
+            py::gil_scoped_release release;
+            std::vector<Metavision::EventCD> batch(view.count);
+            for (py::ssize_t i = 0; i < view.count; ++i) {
+                batch[i] = view.at(i);
+            }
+            const std::vector<uint8_t> keep = self.classify_events(batch);
+            for (py::ssize_t i = 0; i < view.count; ++i) {
+                out[i] = keep[i] != 0;
+            }
+        }
+        return mask;
+    });
+#endif
+}
@@ -21,6 +21,7 @@
 #include <opencv2/opencv.hpp>
 #include "hv_event_reader.h"
 #include <hv_algo/denoise/double_window_filter.h>
+#include <hv_algo/utils/event_merger.h>
 #include <metavision/sdk/core/algorithms/periodic_frame_generation_algorithm.h>
 
 using namespace hv;
@@ -85,26 +86,12 @@ int main(int argc, char** argv) {
     // 创建单个帧生成器，宽度加倍以容纳原始和去噪数据
     Metavision::PeriodicFrameGenerationAlgorithm frame_gen(width * 2, height, acc, fps);
     
-    // 准备合并的事件数据
+    // 按时间戳归并原始事件（左半部分）与去噪事件（右半部分，x坐标偏移width），两路都已按时间排序
     std::vector<Metavision::EventCD> combined_events;
-    
-    // 将原始事件添加到左半部分（x坐标不变）
-    for (const auto& event : all_events) {
-        combined_events.push_back(event);
-    }
-    
-    // 将去噪事件添加到右半部分（x坐标偏移width）
-    for (const auto& event : denoised_events) {
-        Metavision::EventCD shifted_event = event;
-        shifted_event.x += width; // 偏移到右半部分
-        combined_events.push_back(shifted_event);
-    }
-    
-    // 按时间戳排序合并后的事件
-    std::sort(combined_events.begin(), combined_events.end(), 
-              [](const Metavision::EventCD& a, const Metavision::EventCD& b) {
-                  return a.t < b.t;
-              });
+    Shimeta::Algorithm::Utils::EventMerger::merge(
+        {{all_events.data(), all_events.data() + all_events.size()},
+         {denoised_events.data(), denoised_events.data() + denoised_events.size()}},
+        combined_events, {{0, 0}, {width, 0}});
     
     // 设置回调函数
     cv::Mat display_frame;
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hv_event_reader.h"
+#include <hv_algo/denoise/fused_pipeline.h>
+#include <hv_algo/denoise/hot_pixel_filter.h>
+#include <hv_algo/denoise/refractory_filter.h>
+#include <hv_algo/denoise/yang_noise_filter.h>
+
+using namespace hv;
+using namespace Shimeta::Algorithm::Denoise;
+
+namespace {
+
+// 合成事件流：沿 x 方向移动的边缘，叠加 20% 的均匀背景噪声，部分边缘事件带同一像素的突发
+std::vector<Metavision::EventCD> synthesize(int width, int height, size_t count) {
+    std::mt19937 rng(11);
+    std::vector<Metavision::EventCD> events(count);
+    Metavision::timestamp t = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const bool noise = rng() % 5 == 0;
+        const unsigned short x = static_cast<unsigned short>(noise ? rng() % width : (t / 50 + rng() % 4) % width);
+        const unsigned short y = static_cast<unsigned short>(rng() % height);
+        events[i] = Metavision::EventCD(x, y, static_cast<short>(rng() & 1), t);
+        if (!noise && rng() % 8 == 0 && i + 1 < count) {
+            const short p = events[i].p;
+            events[++i] = Metavision::EventCD(x, y, p, t + 1);
+        }
+        t += (rng() % 4 == 0) ? 1 : 0;
+    }
+    return events;
+}
+
+struct Filters {
+    HotPixelFilter hotPixel;
+    RefractoryFilter refractory;
+    YangNoiseFilter yang;
+
+    Filters(int width, int height) :
+        hotPixel(width, height),
+        refractory(width, height, 100),
+        yang(static_cast<int16_t>(width), static_cast<int16_t>(height), 10000, 1, 2) {}
+
+    void reset() {
+        hotPixel.initialize();
+        refractory.initialize();
+        yang.initialize();
+    }
+};
+
+// 按批次处理全部事件，取多次运行中的最快一次
+template <typename Run>
+double measure(Filters &filters, const std::vector<std::vector<Metavision::EventCD>> &batches, size_t total,
+               std::vector<Metavision::EventCD> &kept, const Run &run) {
+    const int runs = 3;
+    double best = 0.0;
+    std::vector<Metavision::EventCD> out;
+    for (int r = 0; r < runs; ++r) {
+        filters.reset();
+        kept.clear();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto &batch : batches) {
+            run(batch, out);
+            kept.insert(kept.end(), out.begin(), out.end());
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        if (r == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return total / best * 1e-6;
+}
+
+bool sameEvents(const std::vector<Metavision::EventCD> &a, const std::vector<Metavision::EventCD> &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const auto &lhs, const auto &rhs) {
+        return lhs.x == rhs.x && lhs.y == rhs.y && lhs.p == rhs.p && lhs.t == rhs.t;
+    });
+}
+
+// 打印一条滤波链的对比结果，返回两种方式的输出是否一致
+bool report(const std::string &chain, double sequentialRate, double fusedRate,
+            const std::vector<Metavision::EventCD> &sequential, const std::vector<Metavision::EventCD> &fused) {
+    const bool same = sameEvents(sequential, fused);
+    std::cout << "滤波链: " << chain << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  逐级串联: " << sequentialRate << " Mev/s" << std::endl;
+    std::cout << "  融合流水线: " << fusedRate << " Mev/s（" << std::setprecision(2) << fusedRate / sequentialRate
+              << "x）" << std::endl;
+    std::cout << "  保留事件数: " << fused.size() << "，与逐级串联" << (same ? "一致" : "不一致") << std::endl
+              << std::endl;
+    return same;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = 1280;
+    int height = 720;
+    std::vector<Metavision::EventCD> events;
+    if (argc >= 2) {
+        HVEventReader reader;
+        if (!reader.open(argv[1])) {
+            std::cerr << "无法打开事件文件: " << argv[1] << std::endl;
+            return -1;
+        }
+        auto size = reader.getImageSize();
+        width = size.first;
+        height = size.second;
+        if (reader.readAllEvents(events) == 0) {
+            std::cerr << "事件文件为空或读取失败。" << std::endl;
+            return -1;
+        }
+        std::cout << "事件文件: " << argv[1] << std::endl;
+    } else {
+        events = synthesize(width, height, 10000000);
+        std::cout << "未指定事件文件，使用合成事件流" << std::endl;
+    }
+    std::cout << "图像尺寸: " << width << "x" << height << "，事件数: " << events.size() << std::endl;
+    std::cout << std::endl;
+
+    // 按相机回调的批次大小切分
+    const size_t batch_size = 65536;
+    std::vector<std::vector<Metavision::EventCD>> batches;
+    for (size_t first = 0; first < events.size(); first += batch_size) {
+        batches.emplace_back(events.begin() + first, events.begin() + std::min(first + batch_size, events.size()));
+    }
+
+    Filters filters(width, height);
+    bool consistent = true;
+
+    // 前端链只含查表类的滤波器，逐级串联时内存遍历占主要开销
+    {
+        std::vector<Metavision::EventCD> sequential;
+        const double sequentialRate = measure(filters, batches, events.size(), sequential,
+            [&](const std::vector<Metavision::EventCD> &batch, std::vector<Metavision::EventCD> &out) {
+                const std::vector<Metavision::EventCD> stage1 = filters.hotPixel.process_events(batch);
+                filters.refractory.process_events(stage1.data(), stage1.data() + stage1.size(), out);
+            });
+        FusedPipeline pipeline(filters.hotPixel, filters.refractory);
+        std::vector<Metavision::EventCD> fused;
+        const double fusedRate = measure(filters, batches, events.size(), fused,
+            [&](const std::vector<Metavision::EventCD> &batch, std::vector<Metavision::EventCD> &out) {
+                pipeline.process_events(batch.data(), batch.data() + batch.size(), out);
+            });
+        consistent = report("HotPixelFilter -> RefractoryFilter", sequentialRate, fusedRate, sequential, fused) && consistent;
+    }
+
+    // 完整链，邻域滤波器的逐事件计算占主要开销
+    {
+        std::vector<Metavision::EventCD> sequential;
+        std::vector<Metavision::EventCD> stage2;
+        const double sequentialRate = measure(filters, batches, events.size(), sequential,
+            [&](const std::vector<Metavision::EventCD> &batch, std::vector<Metavision::EventCD> &out) {
+                const std::vector<Metavision::EventCD> stage1 = filters.hotPixel.process_events(batch);
+                filters.refractory.process_events(stage1.data(), stage1.data() + stage1.size(), stage2);
+                out = filters.yang.process_events(stage2);
+            });
+        FusedPipeline pipeline(filters.hotPixel, filters.refractory, filters.yang);
+        std::vector<Metavision::EventCD> fused;
+        const double fusedRate = measure(filters, batches, events.size(), fused,
+            [&](const std::vector<Metavision::EventCD> &batch, std::vector<Metavision::EventCD> &out) {
+                pipeline.process_events(batch.data(), batch.data() + batch.size(), out);
+            });
+        consistent = report("HotPixelFilter -> RefractoryFilter -> YangNoiseFilter", sequentialRate, fusedRate,
+                            sequential, fused) && consistent;
+    }
+    return consistent ? 0 : 1;
+}
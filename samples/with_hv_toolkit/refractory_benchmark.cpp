@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hv_event_reader.h"
+#include <hv_algo/denoise/refractory_filter.h>
+
+using namespace hv;
+using namespace Shimeta::Algorithm::Denoise;
+
+namespace {
+
+// 合成 1280x720 事件流：沿 x 方向移动的边缘，四分之一的事件后跟随同一像素 3 个微秒级突发事件
+std::vector<Metavision::EventCD> synthesize(int width, int height, size_t count) {
+    std::mt19937 rng(3);
+    std::vector<Metavision::EventCD> events(count);
+    Metavision::timestamp t = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned short x = static_cast<unsigned short>((t / 50 + rng() % 64) % width);
+        const unsigned short y = static_cast<unsigned short>(rng() % height);
+        events[i] = Metavision::EventCD(x, y, static_cast<short>(rng() & 1), t);
+        if (rng() % 4 == 0) {
+            for (int k = 1; k <= 3 && i + 1 < count; ++k) {
+                events[++i] = Metavision::EventCD(x, y, 1, t + k);
+            }
+        }
+        t += (rng() % 16 == 0) ? 1 : 0;
+    }
+    return events;
+}
+
+// 以相机回调的批次大小处理全部事件，取多次运行中的最快一次
+void benchmark(const std::string &name, RefractoryFilter &filter, const std::vector<Metavision::EventCD> &events) {
+    const size_t batch_size = 65536;
+    const int runs = 5;
+    std::vector<Metavision::EventCD> out;
+    double best = 0.0;
+    size_t kept = 0;
+    for (int run = 0; run < runs; ++run) {
+        filter.initialize();
+        kept = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t first = 0; first < events.size(); first += batch_size) {
+            const size_t last = std::min(first + batch_size, events.size());
+            filter.process_events(events.data() + first, events.data() + last, out);
+            kept += out.size();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    std::cout << name << ": " << std::fixed << std::setprecision(1) << events.size() / best * 1e-6
+              << " Mev/s，剔除比例: " << std::setprecision(2)
+              << (1.0 - static_cast<double>(kept) / events.size()) * 100.0 << "%" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = 1280;
+    int height = 720;
+    std::vector<Metavision::EventCD> events;
+    if (argc >= 2) {
+        HVEventReader reader;
+        if (!reader.open(argv[1])) {
+            std::cerr << "无法打开事件文件: " << argv[1] << std::endl;
+            return -1;
+        }
+        auto size = reader.getImageSize();
+        width = size.first;
+        height = size.second;
+        if (reader.readAllEvents(events) == 0) {
+            std::cerr << "事件文件为空或读取失败。" << std::endl;
+            return -1;
+        }
+        std::cout << "事件文件: " << argv[1] << std::endl;
+    } else {
+        events = synthesize(width, height, 30000000);
+        std::cout << "未指定事件文件，使用合成事件流" << std::endl;
+    }
+    std::cout << "图像尺寸: " << width << "x" << height << "，事件数: " << events.size() << std::endl << std::endl;
+
+    RefractoryFilter dead_time(width, height, 100);
+    benchmark("死区 100us", dead_time, events);
+
+    RefractoryFilter rate_limited(width, height, 100, 1000.0, 4);
+    benchmark("死区 100us + 限速 1kHz/4", rate_limited, events);
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "hv_event_reader.h"
+#include <hv_algo/utils/event_roi_mapper.h>
+
+using namespace hv;
+using namespace Shimeta::Algorithm::Utils;
+
+namespace {
+
+std::vector<Metavision::EventCD> synthesize(int width, int height, size_t count) {
+    std::mt19937 rng(5);
+    std::vector<Metavision::EventCD> events(count);
+    for (size_t i = 0; i < count; ++i) {
+        events[i] = Metavision::EventCD(static_cast<unsigned short>(rng() % width),
+                                        static_cast<unsigned short>(rng() % height), static_cast<short>(rng() & 1),
+                                        static_cast<Metavision::timestamp>(i / 16));
+    }
+    return events;
+}
+
+// 逐区域逐事件的参考实现，输出顺序与 EventRoiMapper 相同
+std::vector<Metavision::EventCD> reference(const std::vector<Metavision::EventCD> &events,
+                                           const std::vector<EventRoiMapper::Roi> &rois, int binning) {
+    std::vector<Metavision::EventCD> out;
+    for (const Metavision::EventCD &event : events) {
+        int outputX = 0;
+        for (const EventRoiMapper::Roi &roi : rois) {
+            if (event.x >= roi.x && event.x < roi.x + roi.width && event.y >= roi.y && event.y < roi.y + roi.height) {
+                out.push_back(Metavision::EventCD(static_cast<unsigned short>(outputX + (event.x - roi.x) / binning),
+                                                  static_cast<unsigned short>((event.y - roi.y) / binning), event.p,
+                                                  event.t));
+            }
+            outputX += (roi.width + binning - 1) / binning;
+        }
+    }
+    return out;
+}
+
+bool sameEvents(const std::vector<Metavision::EventCD> &a, const std::vector<Metavision::EventCD> &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const auto &l, const auto &r) {
+        return l.x == r.x && l.y == r.y && l.p == r.p && l.t == r.t;
+    });
+}
+
+// 与参考实现比较；小批次覆盖“最后一个事件落在靠前区域”的情形，此时其余区域仍会写入输出末尾之后的位置
+bool verify(const std::string &name, const EventRoiMapper &mapper, const std::vector<EventRoiMapper::Roi> &rois,
+            int binning, const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> out;
+    for (size_t size : {size_t(1), size_t(2), size_t(3), size_t(17), events.size()}) {
+        for (size_t first = 0; first + size <= std::min(events.size(), size * 64); first += size) {
+            const std::vector<Metavision::EventCD> batch(events.begin() + first, events.begin() + first + size);
+            mapper.process_events(batch.data(), batch.data() + batch.size(), out);
+            if (!sameEvents(out, reference(batch, rois, binning))) {
+                std::cout << name << ": 与参考实现不一致（批次大小 " << size << "）" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void benchmark(const std::string &name, const EventRoiMapper &mapper, const std::vector<Metavision::EventCD> &events) {
+    const size_t batch_size = 65536;
+    std::vector<Metavision::EventCD> out;
+    size_t kept = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t first = 0; first < events.size(); first += batch_size) {
+        const size_t last = std::min(first + batch_size, events.size());
+        mapper.process_events(events.data() + first, events.data() + last, out);
+        kept += out.size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << name << ": 画布 " << mapper.outputWidth() << "x" << mapper.outputHeight() << "，" << std::fixed
+              << std::setprecision(1) << events.size() / elapsed.count() * 1e-6 << " Mev/s，保留比例: "
+              << std::setprecision(2) << static_cast<double>(kept) / events.size() * 100.0 << "%" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = 1280;
+    int height = 720;
+    std::vector<Metavision::EventCD> events;
+    if (argc >= 2) {
+        HVEventReader reader;
+        if (!reader.open(argv[1])) {
+            std::cerr << "无法打开事件文件: " << argv[1] << std::endl;
+            return -1;
+        }
+        auto size = reader.getImageSize();
+        width = size.first;
+        height = size.second;
+        if (reader.readAllEvents(events) == 0) {
+            std::cerr << "事件文件为空或读取失败。" << std::endl;
+            return -1;
+        }
+        std::cout << "事件文件: " << argv[1] << std::endl;
+    } else {
+        events = synthesize(width, height, 10000000);
+        std::cout << "未指定事件文件，使用合成事件流" << std::endl;
+    }
+    std::cout << "图像尺寸: " << width << "x" << height << "，事件数: " << events.size() << std::endl << std::endl;
+
+    // 并排互不重叠的区域，以及相互重叠的区域
+    const std::vector<EventRoiMapper::Roi> disjoint = {
+        {0, 0, width / 4, height / 2}, {width / 4, 0, width / 4, height / 2},
+        {width / 2, height / 2, width / 4, height / 2}, {3 * width / 4, 0, width / 4, height}};
+    const std::vector<EventRoiMapper::Roi> overlapping = {{0, 0, width / 2, height / 2}, {width / 4, height / 4, width / 2, height / 2}};
+
+    bool ok = true;
+    for (int binning : {1, 2, 4}) {
+        const std::string suffix = "，合并 " + std::to_string(binning) + "x" + std::to_string(binning);
+        const EventRoiMapper full(width, height, {}, binning);
+        const EventRoiMapper split(width, height, disjoint, binning);
+        const EventRoiMapper overlap(width, height, overlapping, binning);
+        ok = verify("整幅" + suffix, full, {{0, 0, width, height}}, binning, events) && ok;
+        ok = verify("4 个不重叠区域" + suffix, split, disjoint, binning, events) && ok;
+        ok = verify("2 个重叠区域" + suffix, overlap, overlapping, binning, events) && ok;
+        benchmark("整幅" + suffix, full, events);
+        benchmark("4 个不重叠区域" + suffix, split, events);
+        benchmark("2 个重叠区域" + suffix, overlap, events);
+    }
+    std::cout << (ok ? "结果与参考实现一致" : "结果与参考实现不一致") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "hv_event_reader.h"
+#include <hv_algo/denoise/reclusive_event_denoisor.h>
+#include <hv_algo/denoise/timesurface_denoisor.h>
+#include <hv_algo/denoise/yang_noise_filter.h>
+
+using namespace hv;
+using namespace Shimeta::Algorithm;
+
+namespace {
+
+const std::vector<std::pair<Utils::SurfaceLayout, const char *>> kLayouts = {
+    {Utils::SurfaceLayout::Columns, "Columns"},
+    {Utils::SurfaceLayout::Rows, "Rows"},
+    {Utils::SurfaceLayout::Tiled, "Tiled"},
+    {Utils::SurfaceLayout::Morton, "Morton"},
+};
+
+// 合成事件流：若干条沿 x 方向移动的竖直边缘，叠加 10% 的均匀背景噪声
+std::vector<Metavision::EventCD> synthesize(int width, int height, size_t count) {
+    std::mt19937 rng(7);
+    std::vector<Metavision::EventCD> events(count);
+    const int edges = 8;
+    for (size_t i = 0; i < count; ++i) {
+        const Metavision::timestamp t = static_cast<Metavision::timestamp>(i / 20);
+        unsigned short x;
+        unsigned short y;
+        if (rng() % 10 == 0) {
+            x = static_cast<unsigned short>(rng() % width);
+            y = static_cast<unsigned short>(rng() % height);
+        } else {
+            const int edge = static_cast<int>(rng() % edges);
+            x = static_cast<unsigned short>((t / 100 + edge * width / edges + rng() % 3) % width);
+            y = static_cast<unsigned short>(rng() % height);
+        }
+        events[i] = Metavision::EventCD(x, y, static_cast<short>(rng() & 1), t);
+    }
+    return events;
+}
+
+// 取多次运行中的最快一次，返回吞吐量（Mev/s）
+template <typename Filter>
+double throughput(Filter &filter, const std::vector<Metavision::EventCD> &events) {
+    const int runs = 3;
+    double best = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t kept = 0;
+        for (const auto &event : events) {
+            kept += filter.retain(event) ? 1 : 0;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        if (kept > events.size()) {
+            return 0.0;
+        }
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return events.size() / best * 1e-6;
+}
+
+// 对一个滤波器在每种布局下测速，并给出最快的布局
+template <typename Make>
+void compareLayouts(const std::string &name, const std::vector<Metavision::EventCD> &events, const Make &make) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right;
+    double best = 0.0;
+    const char *bestName = "";
+    for (const auto &layout : kLayouts) {
+        auto filter = make(layout.first);
+        const double rate = throughput(filter, events);
+        std::cout << std::setw(10) << std::fixed << std::setprecision(1) << rate;
+        if (rate > best) {
+            best = rate;
+            bestName = layout.second;
+        }
+    }
+    std::cout << "   最佳: " << bestName << std::endl;
+}
+
+// 任意两种布局之间保存并恢复状态：前半段事件在保存布局上处理，后半段在加载布局上处理，
+// 结果应与不中断地处理整段事件完全一致
+template <typename Make>
+bool checkRoundTrip(const std::string &name, const std::vector<Metavision::EventCD> &events, const Make &make) {
+    const std::string path = "surface_layout_benchmark.state";
+    const size_t half = events.size() / 2;
+    std::vector<bool> expected;
+    {
+        auto reference = make(Utils::SurfaceLayout::Columns);
+        for (const auto &event : events) {
+            expected.push_back(reference.retain(event));
+        }
+    }
+    std::cout << "  " << std::left << std::setw(10) << name << std::right;
+    bool ok = true;
+    for (const auto &saved : kLayouts) {
+        for (const auto &loaded : kLayouts) {
+            bool match = true;
+            try {
+                auto writer = make(saved.first);
+                for (size_t i = 0; i < half; ++i) {
+                    writer.retain(events[i]);
+                }
+                writer.save_state(path);
+                auto reader = make(loaded.first);
+                reader.load_state(path);
+                for (size_t i = half; i < events.size() && match; ++i) {
+                    match = reader.retain(events[i]) == expected[i];
+                }
+            } catch (const std::exception &e) {
+                std::cout << std::endl << "    " << saved.second << " -> " << loaded.second << ": " << e.what();
+                match = false;
+            }
+            if (!match) {
+                std::cout << std::endl << "    " << saved.second << " -> " << loaded.second << " 结果不一致";
+                ok = false;
+            }
+        }
+    }
+    std::remove(path.c_str());
+    std::cout << (ok ? "   状态往返一致" : "\n  状态往返失败") << std::endl;
+    return ok;
+}
+
+bool checkRoundTrips(int width, int height, const std::vector<Metavision::EventCD> &events) {
+    const std::vector<Metavision::EventCD> head(events.begin(), events.begin() + std::min<size_t>(events.size(), 200000));
+    std::cout << "状态保存/恢复（" << width << "x" << height << "，各布局两两组合）" << std::endl;
+    bool ok = true;
+    ok &= checkRoundTrip("Yang", head, [&](Utils::SurfaceLayout layout) {
+        return Denoise::YangNoiseFilter(static_cast<int16_t>(width), static_cast<int16_t>(height), 10000, 1, 2,
+                                        false, layout);
+    });
+    ok &= checkRoundTrip("RED", head, [&](Utils::SurfaceLayout layout) {
+        return Denoise::ReclusiveEventDenoisor(width, height, 5000, 1, layout);
+    });
+    ok &= checkRoundTrip("TimeSurf", head, [&](Utils::SurfaceLayout layout) {
+        return Denoise::TimeSurfaceDenoisor(width, height, 20000, 1, 0.2, layout);
+    });
+    std::cout << std::endl;
+    return ok;
+}
+
+void benchmark(int width, int height, const std::vector<Metavision::EventCD> &events) {
+    std::cout << "图像尺寸: " << width << "x" << height << "，事件数: " << events.size() << std::endl;
+    for (int radius = 1; radius <= 3; ++radius) {
+        std::cout << "半径 " << radius << "（Mev/s）" << std::setw(6) << "";
+        for (const auto &layout : kLayouts) {
+            std::cout << std::setw(10) << layout.second;
+        }
+        std::cout << std::endl;
+        compareLayouts("Yang", events, [&](Utils::SurfaceLayout layout) {
+            return Denoise::YangNoiseFilter(static_cast<int16_t>(width), static_cast<int16_t>(height), 10000,
+                                            radius, 2, false, layout);
+        });
+        compareLayouts("RED", events, [&](Utils::SurfaceLayout layout) {
+            return Denoise::ReclusiveEventDenoisor(width, height, 5000, radius, layout);
+        });
+        compareLayouts("TimeSurf", events, [&](Utils::SurfaceLayout layout) {
+            return Denoise::TimeSurfaceDenoisor(width, height, 20000, radius, 0.2, layout);
+        });
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2) {
+        HVEventReader reader;
+        if (!reader.open(argv[1])) {
+            std::cerr << "无法打开事件文件: " << argv[1] << std::endl;
+            return -1;
+        }
+        auto size = reader.getImageSize();
+        std::vector<Metavision::EventCD> events;
+        if (reader.readAllEvents(events) == 0) {
+            std::cerr << "事件文件为空或读取失败。" << std::endl;
+            return -1;
+        }
+        std::cout << "事件文件: " << argv[1] << std::endl;
+        const bool ok = checkRoundTrips(size.first, size.second, events);
+        benchmark(size.first, size.second, events);
+        return ok ? 0 : 1;
+    }
+
+    std::cout << "未指定事件文件，使用合成事件流" << std::endl << std::endl;
+    const std::vector<std::pair<int, int>> resolutions = {{346, 260}, {640, 480}, {1280, 720}};
+    bool ok = true;
+    for (const auto &resolution : resolutions) {
+        const auto events = synthesize(resolution.first, resolution.second, 2000000);
+        ok &= checkRoundTrips(resolution.first, resolution.second, events);
+        benchmark(resolution.first, resolution.second, events);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <metavision/sdk/stream/camera.h>
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/core/algorithms/periodic_frame_generation_algorithm.h>
+#include <metavision/sdk/ui/utils/window.h>
+#include <metavision/sdk/ui/utils/event_loop.h>
+
+#include <iostream>
+#include <thread>
+
+#include <hv_algo/denoise/event_flow_filter.h>
+#include <hv_algo/denoise/load_shedding_controller.h>
+#include <hv_algo/denoise/yang_noise_filter.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
+
+using namespace Shimeta::Algorithm::Denoise;
+
+// main loop
+int main(int argc, char *argv[]) {
+    Metavision::Camera cam; // create the camera
+
+    if (argc >= 2) {
+        // if we passed a file path, open it
+        cam = Metavision::Camera::from_file(argv[1]);
+    } else {
+        // open the first available camera
+        cam = Metavision::Camera::from_first_available();
+    }
+
+    // Get camera geometry
+    int camera_width  = cam.geometry().get_width();
+    int camera_height = cam.geometry().get_height();
+
+    // Create the filters used by the degradation levels, from the most to the least expensive
+    EventFlowFilter flow_filter(100, 1, 20.0, 2000);
+    YangNoiseFilter ynoise_filter(camera_width, camera_height, 10000, 1, 2);
+    // The subsampled level keeps only every second row and column, so it runs its own filter on the reduced
+    // grid: neighbouring cells there are the nearest pixels that still receive events
+    const int stride = 2;
+    YangNoiseFilter subsampled_filter((camera_width + stride - 1) / stride, (camera_height + stride - 1) / stride,
+                                      10000, 1, 2);
+
+    // Keep the estimated latency under 20 ms, degrading to cheaper levels when the event rate spikes
+    LoadSheddingController controller(20000);
+    controller.addLevel("event_flow", [&](const std::vector<Metavision::EventCD> &events) {
+        return flow_filter.process_events(events);
+    });
+    controller.addLevel("yang", [&](const std::vector<Metavision::EventCD> &events) {
+        return ynoise_filter.process_events(events);
+    });
+    controller.addLevel("yang_subsampled", [&](const std::vector<Metavision::EventCD> &events) {
+        std::vector<Metavision::EventCD> retained_events;
+        for (const auto &event : LoadSheddingController::subsample(events, stride)) {
+            Metavision::EventCD reduced = event;
+            reduced.x /= stride;
+            reduced.y /= stride;
+            if (subsampled_filter.retain(reduced)) {
+                retained_events.push_back(event);
+            }
+        }
+        return retained_events;
+    });
+    controller.setModeSwitchCallback([](const LoadSheddingController::ModeSwitch &info) {
+        std::cout << "[" << info.t << " us] " << info.fromName << " -> " << info.toName
+                  << " rate: " << static_cast<int64_t>(info.inputRate) << " ev/s"
+                  << " latency: " << static_cast<int64_t>(info.latency) << " us" << std::endl;
+    });
+
+    // Create a frame generator for visualization (optional)
+    const std::uint32_t acc = 20000; // Accumulation time in microseconds (20ms)
+    double fps              = 50;    // Frames per second
+    auto frame_gen = Metavision::PeriodicFrameGenerationAlgorithm(camera_width, camera_height, acc, fps);
+
+    // Create a window for visualization (optional)
+    Metavision::Window window("Metavision SDK Adaptive Denoising", camera_width, camera_height,
+                              Metavision::BaseWindow::RenderMode::BGR);
+
+    // Set a callback on the window to close it when Escape or Q is pressed (optional)
+    window.set_keyboard_callback(
+        [&window](Metavision::UIKeyEvent key, int scancode, Metavision::UIAction action, int mods) {
+            if (action == Metavision::UIAction::RELEASE &&
+                (key == Metavision::UIKeyEvent::KEY_ESCAPE || key == Metavision::UIKeyEvent::KEY_Q)) {
+                window.set_close_flag();
+            }
+        });
+
+    // Recycle event buffers across callbacks so the steady state does not allocate
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+
+    // Decouple decoding from filtering: the camera callback only copies batches into a preallocated ring
+    Shimeta::Algorithm::Utils::EventRing event_ring;
+
+    // Add a callback to the camera's CD event stream
+    cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+        // Never blocks; when the ring is full the whole batch is dropped and counted
+        event_ring.push(begin, end);
+    });
+
+    // Filter on a worker thread so a slow filter cannot stall the SDK decoding thread
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            // Copy the camera buffer into a recycled buffer, it goes back to the pool when the callback returns
+            auto input_events = buffer_pool.acquire(begin, end);
+            // Process events with whichever level the controller currently selects
+            std::vector<Metavision::EventCD> denoised_events = controller.process_events(*input_events);
+
+            // Pass denoised events to the frame generator for visualization (optional)
+            if (!denoised_events.empty()) {
+                frame_gen.process_events(denoised_events.begin(), denoised_events.end());
+            }
+        });
+    });
+
+    // Set a callback on the frame generator to display the frame (optional)
+    frame_gen.set_output_callback([&](Metavision::timestamp, cv::Mat &frame) { window.show(frame); });
+
+    // Start the camera
+    cam.start();
+
+    // Keep running until the camera is off, the recording is finished or the window is closed
+    while (cam.is_running() && !window.should_close()) {
+        // Poll events from the system (keyboard, mouse etc.)
+        static constexpr std::int64_t kSleepPeriodMs = 20;
+        Metavision::EventLoop::poll_and_dispatch(kSleepPeriodMs);
+    }
+
+    // Stop the camera
+    cam.stop();
+
+    // Let the worker drain the batches still in the ring
+    event_ring.close();
+    worker.join();
+
+    // Report buffer usage and ring overflows (optional)
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
+
+    return 0;
+}
\ No newline at end of file
@@ -19,7 +19,12 @@
 #include <metavision/sdk/ui/utils/window.h>
 #include <metavision/sdk/ui/utils/event_loop.h>
 
+#include <iostream>
+#include <thread>
+
 #include <hv_algo/denoise/event_flow_filter.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
 
 int main(int argc, char *argv[]) {
     Metavision::Camera cam;
@@ -48,13 +53,19 @@ int main(int argc, char *argv[]) {
             }
         });
 
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+    Shimeta::Algorithm::Utils::EventRing event_ring;
     cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
-        std::vector<Metavision::EventCD> denoised_events;
-        std::vector<Metavision::EventCD> input_events(begin, end);
-        denoised_events = eff_filter.process_events(input_events);
-        if (!denoised_events.empty()) {
-            frame_gen.process_events(denoised_events.begin(), denoised_events.end());
-        }
+        event_ring.push(begin, end);
+    });
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            auto denoised_events = buffer_pool.acquire();
+            eff_filter.process_events(begin, end, *denoised_events);
+            if (!denoised_events->empty()) {
+                frame_gen.process_events(denoised_events->begin(), denoised_events->end());
+            }
+        });
     });
 
     frame_gen.set_output_callback([&](Metavision::timestamp, cv::Mat &frame) { window.show(frame); });
@@ -64,5 +75,14 @@ int main(int argc, char *argv[]) {
         Metavision::EventLoop::poll_and_dispatch(kSleepPeriodMs);
     }
     cam.stop();
+    event_ring.close();
+    worker.join();
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <metavision/sdk/stream/camera.h>
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/core/algorithms/periodic_frame_generation_algorithm.h>
+#include <metavision/sdk/ui/utils/window.h>
+#include <metavision/sdk/ui/utils/event_loop.h>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <hv_algo/denoise/hot_pixel_filter.h>
+#include <hv_algo/denoise/yang_noise_filter.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
+// main loop
+int main(int argc, char *argv[]) {
+    Metavision::Camera cam; // create the camera
+
+    if (argc >= 2) {
+        // if we passed a file path, open it
+        cam = Metavision::Camera::from_file(argv[1]);
+    } else {
+        // open the first available camera
+        cam = Metavision::Camera::from_first_available();
+    }
+
+    // Get camera geometry
+    int camera_width  = cam.geometry().get_width();
+    int camera_height = cam.geometry().get_height();
+
+    // Create the hot pixel mask stage, loading a previously learned mask if one exists
+    // Pixels firing at 1000 ev/s or more during the first second are masked
+    const std::string mask_path = (argc >= 3) ? argv[2] : "hot_pixel_mask.bin";
+    Shimeta::Algorithm::Denoise::HotPixelFilter hot_pixel_filter(camera_width, camera_height, 1000.0, 0.0, 1000000);
+    bool mask_saved = false;
+    if (std::filesystem::exists(mask_path)) {
+        hot_pixel_filter.loadMask(mask_path);
+        mask_saved = true;
+        std::cout << "Loaded hot pixel mask: " << mask_path << " (" << hot_pixel_filter.hotPixelCount() << " hot pixels)" << std::endl;
+    }
+
+    // Create a Yang Noise Filter instance that runs on the unmasked events
+    Shimeta::Algorithm::Denoise::YangNoiseFilter ynoise_filter(camera_width, camera_height, 10000, 1, 2);
+
+    // Create a frame generator for visualization (optional)
+    const std::uint32_t acc = 20000; // Accumulation time in microseconds (20ms)
+    double fps              = 50;    // Frames per second
+    auto frame_gen = Metavision::PeriodicFrameGenerationAlgorithm(camera_width, camera_height, acc, fps);
+
+    // Create a window for visualization (optional)
+    Metavision::Window window("Metavision SDK Hot Pixel Masking", camera_width, camera_height,
+                              Metavision::BaseWindow::RenderMode::BGR);
+
+    // Set a callback on the window to close it when Escape or Q is pressed (optional)
+    window.set_keyboard_callback(
+        [&window](Metavision::UIKeyEvent key, int scancode, Metavision::UIAction action, int mods) {
+            if (action == Metavision::UIAction::RELEASE &&
+                (key == Metavision::UIKeyEvent::KEY_ESCAPE || key == Metavision::UIKeyEvent::KEY_Q)) {
+                window.set_close_flag();
+            }
+        });
+
+    // Recycle event buffers across callbacks so the steady state does not allocate
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+
+    // Decouple decoding from filtering: the camera callback only copies batches into a preallocated ring
+    Shimeta::Algorithm::Utils::EventRing event_ring;
+
+    // Add a callback to the camera's CD event stream
+    cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+        // Never blocks; when the ring is full the whole batch is dropped and counted
+        event_ring.push(begin, end);
+    });
+
+    // Filter on a worker thread so a slow filter cannot stall the SDK decoding thread
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            // Take recycled buffers for both stages, they go back to the pool when the callback returns
+            auto unmasked_events = buffer_pool.acquire();
+            auto denoised_events = buffer_pool.acquire();
+            // Reject masked pixels first, then run the Yang filter on what remains
+            hot_pixel_filter.process_events(begin, end, *unmasked_events);
+            ynoise_filter.process_events(unmasked_events->data(), unmasked_events->data() + unmasked_events->size(),
+                                         *denoised_events);
+
+            // Persist the mask once the learning window is over
+            if (!mask_saved && !hot_pixel_filter.isLearning()) {
+                hot_pixel_filter.saveMask(mask_path);
+                mask_saved = true;
+                std::cout << "Saved hot pixel mask: " << mask_path << " (" << hot_pixel_filter.hotPixelCount() << " hot pixels)" << std::endl;
+            }
+
+            // Pass denoised events to the frame generator for visualization (optional)
+            if (!denoised_events->empty()) {
+                frame_gen.process_events(denoised_events->begin(), denoised_events->end());
+            }
+        });
+    });
+
+    // Set a callback on the frame generator to display the frame (optional)
+    frame_gen.set_output_callback([&](Metavision::timestamp, cv::Mat &frame) { window.show(frame); });
+
+    // Start the camera
+    cam.start();
+
+    // Keep running until the camera is off, the recording is finished or the window is closed
+    while (cam.is_running() && !window.should_close()) {
+        // Poll events from the system (keyboard, mouse etc.)
+        static constexpr std::int64_t kSleepPeriodMs = 20;
+        Metavision::EventLoop::poll_and_dispatch(kSleepPeriodMs);
+    }
+
+    // Stop the camera
+    cam.stop();
+
+    // Let the worker drain the batches still in the ring
+    event_ring.close();
+    worker.join();
+
+    // Report buffer usage and ring overflows (optional)
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
+
+    return 0;
+}
\ No newline at end of file
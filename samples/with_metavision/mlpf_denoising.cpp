@@ -19,7 +19,12 @@
 #include <metavision/sdk/ui/utils/window.h>
 #include <metavision/sdk/ui/utils/event_loop.h>
 
+#include <iostream>
+#include <thread>
+
 #include <hv_algo/denoise/multi_layer_perceptron_filter.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
 
 // main loop
 int main(int argc, char *argv[]) {
@@ -81,18 +86,31 @@ int main(int argc, char *argv[]) {
             }
         });
 
+    // Recycle event buffers across callbacks so the steady state does not allocate
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+
+    // Decouple decoding from filtering: the camera callback only copies batches into a preallocated ring
+    Shimeta::Algorithm::Utils::EventRing event_ring;
+
     // Add a callback to the camera's CD event stream
     cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
-        // Use a vector to store the denoised events
-        std::vector<Metavision::EventCD> denoised_events;
-        // Process events with the MLP filter
-        std::vector<Metavision::EventCD> input_events(begin, end);
-        denoised_events = mlp_filter.process_events(input_events);
-
-        // Pass denoised events to the frame generator for visualization (optional)
-        if (!denoised_events.empty()) {
-            frame_gen.process_events(denoised_events.begin(), denoised_events.end());
-        }
+        // Never blocks; when the ring is full the whole batch is dropped and counted
+        event_ring.push(begin, end);
+    });
+
+    // Filter on a worker thread so a slow filter cannot stall the SDK decoding thread
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            // Take a recycled buffer for the denoised events, it goes back to the pool when the callback returns
+            auto denoised_events = buffer_pool.acquire();
+            // Filter the camera buffer directly with the MLP filter
+            mlp_filter.process_events(begin, end, *denoised_events);
+
+            // Pass denoised events to the frame generator for visualization (optional)
+            if (!denoised_events->empty()) {
+                frame_gen.process_events(denoised_events->begin(), denoised_events->end());
+            }
+        });
     });
 
     // Set a callback on the frame generator to display the frame (optional)
@@ -111,5 +129,18 @@ int main(int argc, char *argv[]) {
     // Stop the camera
     cam.stop();
 
+    // Let the worker drain the batches still in the ring
+    event_ring.close();
+    worker.join();
+
+    // Report buffer usage and ring overflows (optional)
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
+
     return 0;
 }
\ No newline at end of file
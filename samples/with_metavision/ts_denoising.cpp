@@ -19,7 +19,12 @@
 #include <metavision/sdk/ui/utils/window.h>
 #include <metavision/sdk/ui/utils/event_loop.h>
 
+#include <iostream>
+#include <thread>
+
 #include <hv_algo/denoise/timesurface_denoisor.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
 
 int main(int argc, char *argv[]) {
     Metavision::Camera cam;
@@ -50,12 +55,19 @@ int main(int argc, char *argv[]) {
             }
         });
 
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+    Shimeta::Algorithm::Utils::EventRing event_ring;
     cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
-        std::vector<Metavision::EventCD> input_events(begin, end);
-        std::vector<Metavision::EventCD> denoised_events = ts_filter.process_events(input_events);
-        if (!denoised_events.empty()) {
-            frame_gen.process_events(denoised_events.begin(), denoised_events.end());
-        }
+        event_ring.push(begin, end);
+    });
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            auto denoised_events = buffer_pool.acquire();
+            ts_filter.process_events(begin, end, *denoised_events);
+            if (!denoised_events->empty()) {
+                frame_gen.process_events(denoised_events->begin(), denoised_events->end());
+            }
+        });
     });
 
     frame_gen.set_output_callback([&](Metavision::timestamp, cv::Mat &frame) { window.show(frame); });
@@ -68,5 +80,14 @@ int main(int argc, char *argv[]) {
     }
 
     cam.stop();
+    event_ring.close();
+    worker.join();
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -19,7 +19,14 @@
 #include <metavision/sdk/ui/utils/window.h>
 #include <metavision/sdk/ui/utils/event_loop.h>
 
+#include <iostream>
+#include <string>
+#include <thread>
+
 #include <hv_algo/denoise/yang_noise_filter.h>
+#include <hv_algo/utils/event_buffer_pool.h>
+#include <hv_algo/utils/event_ring.h>
+#include <hv_algo/utils/latency_tracer.h>
 // main loop
 int main(int argc, char *argv[]) {
     Metavision::Camera cam; // create the camera
@@ -58,18 +65,41 @@ int main(int argc, char *argv[]) {
             }
         });
 
+    // Recycle event buffers across callbacks so the steady state does not allocate
+    Shimeta::Algorithm::Utils::EventBufferPool buffer_pool;
+
+    // Optional latency tracing, enabled by passing an output CSV path as the second argument
+    const std::string latency_path = argc >= 3 ? argv[2] : "";
+    Shimeta::Algorithm::Utils::LatencyTracer latency_tracer({"yang", "frame_generation"}, !latency_path.empty());
+
+    // Decouple decoding from filtering: the camera callback only copies batches into a preallocated ring
+    Shimeta::Algorithm::Utils::EventRing event_ring;
+
     // Add a callback to the camera's CD event stream
     cam.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
-        // Use a vector to store the denoised events
-        std::vector<Metavision::EventCD> denoised_events;
-        // Process events with the DWF filter
-        std::vector<Metavision::EventCD> input_events(begin, end);
-        denoised_events = ynoise_filter.process_events(input_events);
-
-        // Pass denoised events to the frame generator for visualization (optional)
-        if (!denoised_events.empty()) {
-            frame_gen.process_events(denoised_events.begin(), denoised_events.end());
-        }
+        // Never blocks; when the ring is full the whole batch is dropped and counted
+        event_ring.push(begin, end);
+    });
+
+    // Filter on a worker thread so a slow filter cannot stall the SDK decoding thread
+    std::thread worker([&]() {
+        event_ring.consume([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+            // Start the trace from the newest sensor timestamp of the batch; time spent in the ring shows up end to end
+            auto trace = latency_tracer.arrive((end - 1)->t);
+
+            // Take a recycled buffer for the denoised events, it goes back to the pool when the callback returns
+            auto denoised_events = buffer_pool.acquire();
+            // Filter the camera buffer directly with the Yang filter
+            ynoise_filter.process_events(begin, end, *denoised_events);
+            latency_tracer.stage(trace, 0);
+
+            // Pass denoised events to the frame generator for visualization (optional)
+            if (!denoised_events->empty()) {
+                frame_gen.process_events(denoised_events->begin(), denoised_events->end());
+            }
+            latency_tracer.stage(trace, 1);
+            latency_tracer.finish(trace);
+        });
     });
 
     // Set a callback on the frame generator to display the frame (optional)
@@ -88,5 +118,24 @@ int main(int argc, char *argv[]) {
     // Stop the camera
     cam.stop();
 
+    // Let the worker drain the batches still in the ring
+    event_ring.close();
+    worker.join();
+
+    // Report buffer usage and ring overflows (optional)
+    const auto pool_stats = buffer_pool.stats();
+    std::cout << "Event buffer pool: " << pool_stats.buffers << " buffers, high-water mark " << pool_stats.highWaterMark
+              << ", largest buffer " << pool_stats.largestCapacity << " events" << std::endl;
+    const auto ring_stats = event_ring.stats();
+    std::cout << "Event ring: " << ring_stats.pushedBatches << " batches, " << ring_stats.droppedBatches
+              << " dropped (" << ring_stats.droppedEvents << " events), high-water mark " << ring_stats.highWaterMark
+              << " slots" << std::endl;
+    if (latency_tracer.enabled()) {
+        const auto end_to_end = latency_tracer.endToEndSummary();
+        std::cout << "End-to-end latency: p50 " << end_to_end.p50 << " us, p99 " << end_to_end.p99 << " us, p999 "
+                  << end_to_end.p999 << " us" << std::endl;
+        latency_tracer.exportCsv(latency_path);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,444 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv/cluster_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+namespace {
+constexpr int32_t kNone = -1;
+// 每个簇每累计 kSplitCheck 个事件检查一次是否分裂
+constexpr uint32_t kSplitCheck = 32;
+} // namespace
+
+ClusterTracker::ClusterTracker(
+    int width,
+    int height,
+    float radius,
+    Metavision::timestamp maxIdle,
+    uint32_t minEvents,
+    float positionGain,
+    Metavision::timestamp velocityWindow,
+    float velocityGain,
+    float mergeDistance,
+    float splitRatio,
+    size_t maxClusters
+) :
+    mWidth(width),
+    mHeight(height),
+    mRadius(radius),
+    mMaxIdle(maxIdle),
+    mMinEvents(minEvents),
+    mPositionGain(positionGain),
+    mVelocityWindow(velocityWindow),
+    mVelocityGain(velocityGain),
+    mMergeDistance(mergeDistance),
+    mSplitVariance(splitRatio * radius * splitRatio * radius),
+    mMaxClusters(maxClusters),
+    mCellSize(std::max(1, static_cast<int>(std::ceil(radius)))),
+    mGridWidth(0),
+    mGridHeight(0),
+    mAgeHead(kNone),
+    mAgeTail(kNone),
+    mActive(0),
+    mNextId(1),
+    mPeriod(0),
+    mOutputEnd(0)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("ClusterTracker: width and height must be positive");
+    }
+    if (radius <= 0.0f || maxIdle <= 0 || velocityWindow <= 0) {
+        throw std::invalid_argument("ClusterTracker: radius, maxIdle and velocityWindow must be positive");
+    }
+    if (positionGain <= 0.0f || positionGain > 1.0f || velocityGain <= 0.0f || velocityGain > 1.0f) {
+        throw std::invalid_argument("ClusterTracker: gains must be in (0, 1]");
+    }
+    if (maxClusters == 0 || maxClusters > static_cast<size_t>(INT32_MAX)) {
+        throw std::invalid_argument("ClusterTracker: maxClusters out of range");
+    }
+    mGridWidth = (width + mCellSize - 1) / mCellSize;
+    mGridHeight = (height + mCellSize - 1) / mCellSize;
+    initialize();
+}
+
+void ClusterTracker::initialize() {
+    mCellHead.assign(static_cast<size_t>(mGridWidth) * mGridHeight, kNone);
+    mClusters.assign(mMaxClusters, Cluster{});
+    mFree.resize(mMaxClusters);
+    for (size_t i = 0; i < mMaxClusters; ++i) {
+        mFree[i] = static_cast<int32_t>(mMaxClusters - 1 - i);
+    }
+    mAgeHead = kNone;
+    mAgeTail = kNone;
+    mActive = 0;
+    mNextId = 1;
+    mOutputEnd = 0;
+    mTracks.clear();
+}
+
+void ClusterTracker::setTrackOutput(Metavision::timestamp period, TrackCallback callback) {
+    if (period <= 0) {
+        throw std::invalid_argument("ClusterTracker: period must be positive");
+    }
+    mPeriod = period;
+    mOutputEnd = 0;
+    mCallback = std::move(callback);
+}
+
+void ClusterTracker::link(int32_t index) {
+    Cluster &c = mClusters[index];
+    const int cx = std::min(std::max(static_cast<int>(c.x) / mCellSize, 0), mGridWidth - 1);
+    const int cy = std::min(std::max(static_cast<int>(c.y) / mCellSize, 0), mGridHeight - 1);
+    c.cell = cy * mGridWidth + cx;
+    c.cellPrev = kNone;
+    c.cellNext = mCellHead[c.cell];
+    if (c.cellNext != kNone) {
+        mClusters[c.cellNext].cellPrev = index;
+    }
+    mCellHead[c.cell] = index;
+}
+
+void ClusterTracker::unlink(int32_t index) {
+    Cluster &c = mClusters[index];
+    if (c.cellPrev != kNone) {
+        mClusters[c.cellPrev].cellNext = c.cellNext;
+    } else {
+        mCellHead[c.cell] = c.cellNext;
+    }
+    if (c.cellNext != kNone) {
+        mClusters[c.cellNext].cellPrev = c.cellPrev;
+    }
+}
+
+void ClusterTracker::touch(int32_t index) {
+    Cluster &c = mClusters[index];
+    if (mAgeTail == index) {
+        return;
+    }
+    // 从原位置摘除（新建的簇不在链表中）
+    if (c.agePrev != kNone) {
+        mClusters[c.agePrev].ageNext = c.ageNext;
+    } else if (mAgeHead == index) {
+        mAgeHead = c.ageNext;
+    }
+    if (c.ageNext != kNone) {
+        mClusters[c.ageNext].agePrev = c.agePrev;
+    }
+    c.agePrev = mAgeTail;
+    c.ageNext = kNone;
+    if (mAgeTail != kNone) {
+        mClusters[mAgeTail].ageNext = index;
+    } else {
+        mAgeHead = index;
+    }
+    mAgeTail = index;
+}
+
+int32_t ClusterTracker::create(float x, float y, Metavision::timestamp t) {
+    if (mFree.empty()) {
+        remove(mAgeHead);
+    }
+    const int32_t index = mFree.back();
+    mFree.pop_back();
+    Cluster &c = mClusters[index];
+    c = Cluster{};
+    c.id = mNextId++;
+    if (mNextId == kNoCluster) {
+        mNextId = 1;
+    }
+    c.x = x;
+    c.y = y;
+    c.anchorX = x;
+    c.anchorY = y;
+    c.tAnchor = t;
+    c.tFirst = t;
+    c.tLast = t;
+    c.agePrev = kNone;
+    c.ageNext = kNone;
+    link(index);
+    touch(index);
+    ++mActive;
+    return index;
+}
+
+void ClusterTracker::remove(int32_t index) {
+    Cluster &c = mClusters[index];
+    unlink(index);
+    if (c.agePrev != kNone) {
+        mClusters[c.agePrev].ageNext = c.ageNext;
+    } else {
+        mAgeHead = c.ageNext;
+    }
+    if (c.ageNext != kNone) {
+        mClusters[c.ageNext].agePrev = c.agePrev;
+    } else {
+        mAgeTail = c.agePrev;
+    }
+    mFree.push_back(index);
+    --mActive;
+}
+
+void ClusterTracker::expire(Metavision::timestamp t) {
+    while (mAgeHead != kNone && t - mClusters[mAgeHead].tLast > mMaxIdle) {
+        remove(mAgeHead);
+    }
+}
+
+void ClusterTracker::update(int32_t index, const Metavision::EventCD &event) {
+    Cluster &c = mClusters[index];
+    ++c.events;
+    // 前若干个事件取算术平均，之后退化为指数滑动平均
+    const float gain = std::max(mPositionGain, 1.0f / static_cast<float>(c.events));
+    const float dx = event.x - c.x;
+    const float dy = event.y - c.y;
+    c.x += gain * dx;
+    c.y += gain * dy;
+    c.sxx += gain * (dx * dx - c.sxx);
+    c.sxy += gain * (dx * dy - c.sxy);
+    c.syy += gain * (dy * dy - c.syy);
+    c.tLast = event.t;
+
+    const Metavision::timestamp dt = event.t - c.tAnchor;
+    if (dt >= mVelocityWindow) {
+        const float scale = 1e6f / static_cast<float>(dt);
+        const float vx = (c.x - c.anchorX) * scale;
+        const float vy = (c.y - c.anchorY) * scale;
+        if (c.hasVelocity) {
+            c.vx += mVelocityGain * (vx - c.vx);
+            c.vy += mVelocityGain * (vy - c.vy);
+        } else {
+            c.vx = vx;
+            c.vy = vy;
+            c.hasVelocity = true;
+        }
+        c.anchorX = c.x;
+        c.anchorY = c.y;
+        c.tAnchor = event.t;
+    }
+
+    const int cx = std::min(std::max(static_cast<int>(c.x) / mCellSize, 0), mGridWidth - 1);
+    const int cy = std::min(std::max(static_cast<int>(c.y) / mCellSize, 0), mGridHeight - 1);
+    if (cy * mGridWidth + cx != c.cell) {
+        unlink(index);
+        link(index);
+    }
+    touch(index);
+
+    if (c.events % kSplitCheck == 0) {
+        trySplit(index);
+    }
+}
+
+void ClusterTracker::merge(int32_t keep, int32_t drop) {
+    Cluster &a = mClusters[keep];
+    const Cluster &b = mClusters[drop];
+    const float total = static_cast<float>(a.events) + static_cast<float>(b.events);
+    const float wa = total > 0.0f ? static_cast<float>(a.events) / total : 0.5f;
+    const float wb = 1.0f - wa;
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    // 合并后的二阶矩包含两个质心之间的离散
+    a.sxx = wa * a.sxx + wb * b.sxx + wa * wb * dx * dx;
+    a.sxy = wa * a.sxy + wb * b.sxy + wa * wb * dx * dy;
+    a.syy = wa * a.syy + wb * b.syy + wa * wb * dy * dy;
+    a.x = wa * a.x + wb * b.x;
+    a.y = wa * a.y + wb * b.y;
+    if (b.hasVelocity) {
+        a.vx = a.hasVelocity ? wa * a.vx + wb * b.vx : b.vx;
+        a.vy = a.hasVelocity ? wa * a.vy + wb * b.vy : b.vy;
+        a.hasVelocity = true;
+    }
+    a.anchorX = a.x;
+    a.anchorY = a.y;
+    a.tAnchor = std::max(a.tLast, b.tLast);
+    a.events += b.events;
+    a.tFirst = std::min(a.tFirst, b.tFirst);
+    a.tLast = std::max(a.tLast, b.tLast);
+    remove(drop);
+    unlink(keep);
+    link(keep);
+}
+
+void ClusterTracker::trySplit(int32_t index) {
+    const Cluster &c = mClusters[index];
+    if (c.events < 2 * mMinEvents) {
+        return;
+    }
+    const float half = 0.5f * (c.sxx + c.syy);
+    const float diff = 0.5f * (c.sxx - c.syy);
+    const float root = std::sqrt(diff * diff + c.sxy * c.sxy);
+    const float major = half + root;
+    const float minor = std::max(half - root, 0.0f);
+    if (major <= mSplitVariance) {
+        return;
+    }
+    // 簇已满且最久未更新的就是自身时无法分裂
+    if (mFree.empty() && mAgeHead == index) {
+        return;
+    }
+
+    // 主轴方向
+    float ex = 1.0f;
+    float ey = 0.0f;
+    if (std::abs(c.sxy) > 1e-6f) {
+        ex = major - c.syy;
+        ey = c.sxy;
+        const float norm = std::sqrt(ex * ex + ey * ey);
+        ex /= norm;
+        ey /= norm;
+    } else if (c.syy > c.sxx) {
+        ex = 0.0f;
+        ey = 1.0f;
+    }
+    const float offset = std::sqrt(major);
+
+    const Cluster parent = c;
+    const int32_t child = create(parent.x + offset * ex, parent.y + offset * ey, parent.tLast);
+    Cluster &b = mClusters[child];
+    Cluster &a = mClusters[index];
+    a.x = parent.x - offset * ex;
+    a.y = parent.y - offset * ey;
+    a.sxx = minor;
+    a.sxy = 0.0f;
+    a.syy = minor;
+    a.events = parent.events / 2;
+    a.anchorX = a.x;
+    a.anchorY = a.y;
+    a.tAnchor = parent.tLast;
+    b.sxx = minor;
+    b.syy = minor;
+    b.vx = parent.vx;
+    b.vy = parent.vy;
+    b.hasVelocity = parent.hasVelocity;
+    b.events = parent.events - a.events;
+    b.tFirst = parent.tFirst;
+    unlink(index);
+    link(index);
+}
+
+uint32_t ClusterTracker::assign(const Metavision::EventCD &event) {
+    if (mPeriod > 0) {
+        if (mOutputEnd == 0) {
+            mOutputEnd = (event.t / mPeriod + 1) * mPeriod;
+        }
+        while (event.t >= mOutputEnd) {
+            expire(mOutputEnd);
+            snapshot(mOutputEnd, mTracks);
+            if (mCallback) {
+                mCallback(mOutputEnd, mTracks);
+            }
+            mOutputEnd += mPeriod;
+        }
+    }
+    expire(event.t);
+
+    // 只检查周围 3x3 个单元，单元边长不小于关联半径
+    const float x = event.x;
+    const float y = event.y;
+    const int cx = std::min(static_cast<int>(event.x) / mCellSize, mGridWidth - 1);
+    const int cy = std::min(static_cast<int>(event.y) / mCellSize, mGridHeight - 1);
+    const float radius2 = mRadius * mRadius;
+    int32_t best = kNone;
+    int32_t second = kNone;
+    float bestDist = radius2;
+    float secondDist = radius2;
+    for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, mGridHeight - 1); ++gy) {
+        for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, mGridWidth - 1); ++gx) {
+            for (int32_t i = mCellHead[gy * mGridWidth + gx]; i != kNone; i = mClusters[i].cellNext) {
+                const float dx = mClusters[i].x - x;
+                const float dy = mClusters[i].y - y;
+                const float dist = dx * dx + dy * dy;
+                if (dist > secondDist) {
+                    continue;
+                }
+                if (dist <= bestDist) {
+                    second = best;
+                    secondDist = bestDist;
+                    best = i;
+                    bestDist = dist;
+                } else {
+                    second = i;
+                    secondDist = dist;
+                }
+            }
+        }
+    }
+
+    if (best == kNone) {
+        const int32_t index = create(x, y, event.t);
+        update(index, event);
+        return mClusters[index].id;
+    }
+    if (second != kNone) {
+        const float dx = mClusters[best].x - mClusters[second].x;
+        const float dy = mClusters[best].y - mClusters[second].y;
+        if (dx * dx + dy * dy < mMergeDistance * mMergeDistance) {
+            if (mClusters[second].events > mClusters[best].events) {
+                std::swap(best, second);
+            }
+            merge(best, second);
+        }
+    }
+    update(best, event);
+    return mClusters[best].id;
+}
+
+void ClusterTracker::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        assign(*event);
+    }
+}
+
+void ClusterTracker::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                    std::vector<uint32_t> &labels) {
+    labels.clear();
+    labels.reserve(static_cast<size_t>(end - begin));
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        labels.push_back(assign(*event));
+    }
+}
+
+void ClusterTracker::process_events(const std::vector<Metavision::EventCD> &events) {
+    process_events(events.data(), events.data() + events.size());
+}
+
+void ClusterTracker::snapshot(Metavision::timestamp t, std::vector<ClusterTrack> &out) const {
+    out.clear();
+    for (int32_t i = mAgeHead; i != kNone; i = mClusters[i].ageNext) {
+        const Cluster &c = mClusters[i];
+        if (c.events < mMinEvents) {
+            continue;
+        }
+        const float dt = static_cast<float>(t - c.tLast) * 1e-6f;
+        const float half = 0.5f * (c.sxx + c.syy);
+        const float diff = 0.5f * (c.sxx - c.syy);
+        const float major = half + std::sqrt(diff * diff + c.sxy * c.sxy);
+        out.push_back(ClusterTrack{c.id, c.x + c.vx * dt, c.y + c.vy * dt, c.vx, c.vy, std::sqrt(major), c.events,
+                                   c.tFirst, c.tLast});
+    }
+    std::sort(out.begin(), out.end(),
+              [](const ClusterTrack &a, const ClusterTrack &b) { return a.id < b.id; });
+}
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv/corner_detector.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+namespace {
+constexpr Metavision::timestamp kNoEvent = std::numeric_limits<Metavision::timestamp>::min();
+constexpr int kBorder = 4;
+constexpr int kPatch = 2 * kBorder + 1;
+
+// eFAST 的两个 Bresenham 圆，按顺时针排列
+constexpr int kCircle3[16][2] = {
+    {0, 3}, {1, 3}, {2, 2}, {3, 1}, {3, 0}, {3, -1}, {2, -2}, {1, -3},
+    {0, -3}, {-1, -3}, {-2, -2}, {-3, -1}, {-3, 0}, {-3, 1}, {-2, 2}, {-1, 3}};
+constexpr int kCircle4[20][2] = {
+    {0, 4}, {1, 4}, {2, 3}, {3, 2}, {4, 1}, {4, 0}, {4, -1}, {3, -2}, {2, -3}, {1, -4},
+    {0, -4}, {-1, -4}, {-2, -3}, {-3, -2}, {-4, -1}, {-4, 0}, {-4, 1}, {-3, 2}, {-2, 3}, {-1, 4}};
+
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+
+/// 圆上是否存在长度在 [minArc, maxArc] 之间、时间戳全部新于其余像素的连续弧
+template <int N>
+bool hasNewestArc(const Metavision::timestamp (&t)[N], int minArc, int maxArc) {
+    for (int i = 0; i < N; ++i) {
+        // 弧的起点必须新于它前面的像素
+        if (t[i] < t[(i + N - 1) % N]) {
+            continue;
+        }
+        Metavision::timestamp arcMin = t[i];
+        for (int length = 1; length <= maxArc; ++length) {
+            if (length > 1) {
+                arcMin = std::min(arcMin, t[(i + length - 1) % N]);
+            }
+            if (length < minArc) {
+                continue;
+            }
+            // 弧的终点必须新于它后面的像素
+            if (t[(i + length - 1) % N] < t[(i + length) % N]) {
+                continue;
+            }
+            bool newest = true;
+            for (int j = length; j < N; ++j) {
+                if (t[(i + j) % N] >= arcMin) {
+                    newest = false;
+                    break;
+                }
+            }
+            if (newest) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+} // namespace
+
+CornerDetector::CornerDetector(
+    int width,
+    int height,
+    Method method,
+    double harrisThreshold,
+    int harrisQueueSize,
+    int tileRows,
+    size_t threads
+) :
+    mWidth(width),
+    mHeight(height),
+    mMethod(method),
+    mHarrisThreshold(harrisThreshold),
+    mHarrisQueueSize(harrisQueueSize),
+    // 行带高度不小于判定邻域的半径
+    mPartitioner(std::max(height, 1), static_cast<size_t>(std::max(1, height / std::max(tileRows, kBorder))))
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("CornerDetector: width and height must be positive");
+    }
+    if (harrisQueueSize <= 0 || harrisQueueSize > kPatch * kPatch) {
+        throw std::invalid_argument("CornerDetector: harrisQueueSize must be in [1, 81]");
+    }
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    initialize();
+}
+
+void CornerDetector::initialize() {
+    mSae.assign(2 * static_cast<size_t>(mWidth) * mHeight, kNoEvent);
+}
+
+void CornerDetector::setGate(Gate gate) {
+    mGate = std::move(gate);
+}
+
+bool CornerDetector::isFastCorner(const Metavision::timestamp *sae, int x, int y, Metavision::timestamp t) const {
+    // 晚于当前事件的时间戳只会出现在多行带模式的相邻行带中，按从未触发处理
+    auto at = [&](const int (&offset)[2]) {
+        const Metavision::timestamp value = sae[static_cast<size_t>(y + offset[1]) * mWidth + x + offset[0]];
+        return value > t ? kNoEvent : value;
+    };
+    Metavision::timestamp inner[16];
+    for (int i = 0; i < 16; ++i) {
+        inner[i] = at(kCircle3[i]);
+    }
+    if (!hasNewestArc(inner, 3, 6)) {
+        return false;
+    }
+    Metavision::timestamp outer[20];
+    for (int i = 0; i < 20; ++i) {
+        outer[i] = at(kCircle4[i]);
+    }
+    return hasNewestArc(outer, 4, 8);
+}
+
+bool CornerDetector::isHarrisCorner(const Metavision::timestamp *sae, int x, int y, Metavision::timestamp t) const {
+    // 9x9 邻域中最新的 mHarrisQueueSize 个像素置 1，晚于当前事件的时间戳按从未触发处理
+    Metavision::timestamp patch[kPatch * kPatch];
+    Metavision::timestamp sorted[kPatch * kPatch];
+    for (int dy = 0; dy < kPatch; ++dy) {
+        const Metavision::timestamp *row = sae + static_cast<size_t>(y - kBorder + dy) * mWidth + x - kBorder;
+        for (int dx = 0; dx < kPatch; ++dx) {
+            patch[dy * kPatch + dx] = row[dx] > t ? kNoEvent : row[dx];
+        }
+    }
+    std::copy(patch, patch + kPatch * kPatch, sorted);
+    std::nth_element(sorted, sorted + mHarrisQueueSize - 1, sorted + kPatch * kPatch,
+                     std::greater<Metavision::timestamp>());
+    const Metavision::timestamp threshold = std::max(sorted[mHarrisQueueSize - 1], kNoEvent + 1);
+    float binary[kPatch * kPatch];
+    for (int i = 0; i < kPatch * kPatch; ++i) {
+        binary[i] = patch[i] >= threshold ? 1.0f : 0.0f;
+    }
+
+    // 内部 7x7 上的 Sobel 梯度与二阶矩
+    float sxx = 0.0f;
+    float syy = 0.0f;
+    float sxy = 0.0f;
+    for (int py = 1; py < kPatch - 1; ++py) {
+        for (int px = 1; px < kPatch - 1; ++px) {
+            const float *c = binary + py * kPatch + px;
+            const float gx = (c[-kPatch + 1] + 2.0f * c[1] + c[kPatch + 1]) -
+                             (c[-kPatch - 1] + 2.0f * c[-1] + c[kPatch - 1]);
+            const float gy = (c[kPatch - 1] + 2.0f * c[kPatch] + c[kPatch + 1]) -
+                             (c[-kPatch - 1] + 2.0f * c[-kPatch] + c[-kPatch + 1]);
+            sxx += gx * gx;
+            syy += gy * gy;
+            sxy += gx * gy;
+        }
+    }
+    // 归一化为单位阶跃边缘梯度为 1 的平均二阶矩，响应与窗口大小无关
+    const double norm = 1.0 / (16.0 * (kPatch - 2) * (kPatch - 2));
+    const double mxx = sxx * norm;
+    const double myy = syy * norm;
+    const double mxy = sxy * norm;
+    const double score = mxx * myy - mxy * mxy - 0.04 * (mxx + myy) * (mxx + myy);
+    return score > mHarrisThreshold;
+}
+
+bool CornerDetector::detect(const Metavision::EventCD &event) {
+    Metavision::timestamp *sae = mSae.data() + (event.p > 0 ? 1 : 0) * static_cast<size_t>(mWidth) * mHeight;
+    sae[static_cast<size_t>(event.y) * mWidth + event.x] = event.t;
+    if (event.x < kBorder || event.y < kBorder || event.x >= mWidth - kBorder || event.y >= mHeight - kBorder) {
+        return false;
+    }
+    return mMethod == Method::FAST ? isFastCorner(sae, event.x, event.y, event.t)
+                                   : isHarrisCorner(sae, event.x, event.y, event.t);
+}
+
+bool CornerDetector::evaluate(const Metavision::EventCD &event) {
+    if (mGate && !mGate(event)) {
+        return false;
+    }
+    return detect(event);
+}
+
+void CornerDetector::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                    std::vector<Metavision::EventCD> &out) {
+    out.clear();
+    const Metavision::EventCD *first = begin;
+    const Metavision::EventCD *last = end;
+    if (mGate) {
+        // 门控通常是有状态的去噪器，按输入顺序串行执行
+        mGated.clear();
+        for (const Metavision::EventCD *event = begin; event != end; ++event) {
+            if (mGate(*event)) {
+                mGated.push_back(*event);
+            }
+        }
+        first = mGated.data();
+        last = mGated.data() + mGated.size();
+    }
+
+    if (!mPool) {
+        for (const Metavision::EventCD *event = first; event != last; ++event) {
+            if (detect(*event)) {
+                out.push_back(*event);
+            }
+        }
+        return;
+    }
+
+    // 多行带模式：无论批次大小都按行带顺序处理，保证结果只取决于行带划分
+    const size_t count = static_cast<size_t>(last - first);
+    Utils::WorkStealingPool *pool = count >= Utils::EventPartitioner::kParallelThreshold ? mPool.get() : nullptr;
+    mIsCorner.assign(count, 0);
+    mPartitioner.partition(first, last, pool, true);
+    mPartitioner.forEachBandAlternating(pool, [this](size_t band) {
+        const Metavision::EventCD *events = mPartitioner.bandEvents(band);
+        const uint32_t *indices = mPartitioner.bandIndices(band);
+        for (size_t i = 0; i < mPartitioner.bandSize(band); ++i) {
+            mIsCorner[indices[i]] = detect(events[i]) ? 1 : 0;
+        }
+    });
+    for (size_t i = 0; i < count; ++i) {
+        if (mIsCorner[i]) {
+            out.push_back(first[i]);
+        }
+    }
+}
+
+std::vector<Metavision::EventCD> CornerDetector::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> corners;
+    process_events(events.data(), events.data() + events.size(), corners);
+    return corners;
+}
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
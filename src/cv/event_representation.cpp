@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv/event_representation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+namespace {
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+} // namespace
+
+EventRepresentation::EventRepresentation(int width, int height, size_t threads) :
+    mWidth(width),
+    mHeight(height),
+    mPixels(static_cast<size_t>(std::max(width, 0)) * std::max(height, 0)),
+    // 行带数取线程数的 4 倍，缓解事件在画面上分布不均造成的负载倾斜
+    mPartitioner(std::max(height, 1), 4 * resolveThreads(threads))
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("EventRepresentation: width and height must be positive");
+    }
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    mSae.assign(2 * mPixels, kNoEvent);
+}
+
+template <typename Body>
+void EventRepresentation::forEachRows(const Body &body) {
+    if (!mPool) {
+        body(0, mHeight);
+        return;
+    }
+    mPool->parallelFor(0, mPartitioner.bandCount(), [&](size_t first, size_t last) {
+        body(mPartitioner.bandBegin(first), mPartitioner.bandEnd(last - 1));
+    }, 1);
+}
+
+void EventRepresentation::clear(float *out, size_t planes) {
+    forEachRows([&](int rowBegin, int rowEnd) {
+        const size_t offset = static_cast<size_t>(rowBegin) * mWidth;
+        const size_t length = static_cast<size_t>(rowEnd - rowBegin) * mWidth;
+        for (size_t plane = 0; plane < planes; ++plane) {
+            std::memset(out + plane * mPixels + offset, 0, length * sizeof(float));
+        }
+    });
+}
+
+void EventRepresentation::countImage(const Metavision::EventCD *begin, const Metavision::EventCD *end, float *out,
+                                     bool accumulate) {
+    if (!accumulate) {
+        clear(out, 2);
+    }
+    const size_t pixels = mPixels;
+    const size_t width = mWidth;
+    mPartitioner.forEach(begin, end, mPool.get(), [=](size_t, const Metavision::EventCD &event) {
+        out[(event.p > 0 ? pixels : 0) + static_cast<size_t>(event.y) * width + event.x] += 1.0f;
+    });
+}
+
+void EventRepresentation::accumulateTemporal(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                             Metavision::timestamp tStart, Metavision::timestamp tEnd, int bins,
+                                             float *out, bool signedPolarity, size_t polarityStride) {
+    if (bins <= 0) {
+        throw std::invalid_argument("EventRepresentation: bins must be positive");
+    }
+    if (tEnd <= tStart && bins > 1) {
+        throw std::invalid_argument("EventRepresentation: tEnd must be after tStart");
+    }
+    const float scale = bins > 1 ? static_cast<float>(bins - 1) / static_cast<float>(tEnd - tStart) : 0.0f;
+    const size_t pixels = mPixels;
+    const size_t width = mWidth;
+    const int lastBin = bins - 1;
+    mPartitioner.forEach(begin, end, mPool.get(), [=](size_t, const Metavision::EventCD &event) {
+        const float value = (signedPolarity && event.p <= 0) ? -1.0f : 1.0f;
+        // 限幅后再取整，避免窗口外很远的事件在转换为 int 时溢出
+        const float tn = std::min(std::max(static_cast<float>(event.t - tStart) * scale, -2.0f), lastBin + 2.0f);
+        const float lower = std::floor(tn);
+        const float weight = tn - lower;
+        const int bin = static_cast<int>(lower);
+        float *pixel = out + (event.p > 0 ? polarityStride : 0) + static_cast<size_t>(event.y) * width + event.x;
+        if (bin >= 0 && bin <= lastBin) {
+            pixel[bin * pixels] += value * (1.0f - weight);
+        }
+        if (bin + 1 >= 0 && bin + 1 <= lastBin) {
+            pixel[(bin + 1) * pixels] += value * weight;
+        }
+    });
+}
+
+void EventRepresentation::voxelGrid(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                    Metavision::timestamp tStart, Metavision::timestamp tEnd, int bins, float *out,
+                                    bool accumulate) {
+    if (!accumulate) {
+        clear(out, static_cast<size_t>(std::max(bins, 0)));
+    }
+    accumulateTemporal(begin, end, tStart, tEnd, bins, out, true, 0);
+}
+
+void EventRepresentation::eventSpikeTensor(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                           Metavision::timestamp tStart, Metavision::timestamp tEnd, int bins,
+                                           float *out, bool accumulate) {
+    if (!accumulate) {
+        clear(out, 2 * static_cast<size_t>(std::max(bins, 0)));
+    }
+    accumulateTemporal(begin, end, tStart, tEnd, bins, out, false, static_cast<size_t>(std::max(bins, 0)) * mPixels);
+}
+
+void EventRepresentation::update(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    Metavision::timestamp *sae = mSae.data();
+    const size_t pixels = mPixels;
+    const size_t width = mWidth;
+    mPartitioner.forEach(begin, end, mPool.get(), [=](size_t, const Metavision::EventCD &event) {
+        sae[(event.p > 0 ? pixels : 0) + static_cast<size_t>(event.y) * width + event.x] = event.t;
+    });
+}
+
+void EventRepresentation::timeSurface(Metavision::timestamp t, double tau, float *out) {
+    if (tau <= 0) {
+        throw std::invalid_argument("EventRepresentation: tau must be positive");
+    }
+    const float invTau = static_cast<float>(1.0 / tau);
+    forEachRows([&](int rowBegin, int rowEnd) {
+        const size_t first = static_cast<size_t>(rowBegin) * mWidth;
+        const size_t last = static_cast<size_t>(rowEnd) * mWidth;
+        for (size_t plane = 0; plane < 2; ++plane) {
+            const Metavision::timestamp *sae = mSae.data() + plane * mPixels;
+            float *dst = out + plane * mPixels;
+            for (size_t i = first; i < last; ++i) {
+                const bool seen = sae[i] != kNoEvent;
+                const Metavision::timestamp lastT = seen ? sae[i] : t;
+                const float dt = static_cast<float>(std::max<Metavision::timestamp>(t - lastT, 0));
+                dst[i] = seen ? std::exp(-dt * invTau) : 0.0f;
+            }
+        }
+    });
+}
+
+void EventRepresentation::reset() {
+    std::fill(mSae.begin(), mSae.end(), kNoEvent);
+}
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
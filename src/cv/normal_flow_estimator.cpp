@@ -0,0 +1,284 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv/normal_flow_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV {
+
+namespace {
+constexpr int kMaxRadius = 7;
+constexpr Metavision::timestamp kNoEvent = std::numeric_limits<Metavision::timestamp>::min();
+
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+
+/// 以当前事件为原点的邻域点的平面拟合和式。坐标与时间差都是整数，用整数累积保证结果精确
+struct PlaneSums {
+    int64_t n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0, st = 0, sxt = 0, syt = 0;
+
+    /// 累积同一行 dy 上的点，rn/rx/rxx/rt/rxt 为该行的 Σ1, Σdx, Σdx², Σdt, Σdx*dt
+    inline void addRow(int64_t dy, int64_t rn, int64_t rx, int64_t rxx, int64_t rt, int64_t rxt) {
+        n += rn;
+        sx += rx;
+        sy += dy * rn;
+        sxx += rxx;
+        sxy += dy * rx;
+        syy += dy * dy * rn;
+        st += rt;
+        sxt += rxt;
+        syt += dy * rt;
+    }
+
+    /// 用克莱姆法则解 3x3 正规方程，得到 t = a*x + b*y + c
+    inline bool solve(double &a, double &b, double &c) const {
+        auto det3 = [](double m00, double m01, double m02, double m10, double m11, double m12,
+                       double m20, double m21, double m22) {
+            return m00 * (m11 * m22 - m12 * m21) - m01 * (m10 * m22 - m12 * m20) + m02 * (m10 * m21 - m11 * m20);
+        };
+        const double n = static_cast<double>(this->n), sx = static_cast<double>(this->sx);
+        const double sy = static_cast<double>(this->sy), sxx = static_cast<double>(this->sxx);
+        const double sxy = static_cast<double>(this->sxy), syy = static_cast<double>(this->syy);
+        const double st = static_cast<double>(this->st), sxt = static_cast<double>(this->sxt);
+        const double syt = static_cast<double>(this->syt);
+        const double det = det3(sxx, sxy, sx, sxy, syy, sy, sx, sy, n);
+        if (std::abs(det) < 1e-9) {
+            return false;
+        }
+        a = det3(sxt, sxy, sx, syt, syy, sy, st, sy, n) / det;
+        b = det3(sxx, sxt, sx, sxy, syt, sy, sx, st, n) / det;
+        c = det3(sxx, sxy, sxt, sxy, syy, syt, sx, sy, st) / det;
+        return true;
+    }
+};
+} // namespace
+
+NormalFlowEstimator::NormalFlowEstimator(
+    int width,
+    int height,
+    int radius,
+    Metavision::timestamp duration,
+    int minNeighbors,
+    double fitTolerance,
+    int tileRows,
+    size_t threads
+) :
+    mWidth(width),
+    mHeight(height),
+    mRadius(radius),
+    mDuration(duration),
+    mMinNeighbors(std::max(minNeighbors, 3)),
+    mFitTolerance(fitTolerance),
+    // 行带高度不小于邻域半径，保证邻域最多跨越相邻的一个行带
+    mPartitioner(std::max(height, 1), static_cast<size_t>(std::max(1, height / std::max(tileRows, radius)))),
+    mFieldPeriod(0),
+    mFieldEnd(0)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("NormalFlowEstimator: width and height must be positive");
+    }
+    if (radius < 1 || radius > kMaxRadius) {
+        throw std::invalid_argument("NormalFlowEstimator: radius must be in [1, 7]");
+    }
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    initialize();
+}
+
+void NormalFlowEstimator::initialize() {
+    mSae.assign(2 * static_cast<size_t>(mWidth) * mHeight, kNoEvent);
+    mFieldEnd = 0;
+    std::fill(mSumX.begin(), mSumX.end(), 0.0);
+    std::fill(mSumY.begin(), mSumY.end(), 0.0);
+    std::fill(mSumCount.begin(), mSumCount.end(), 0U);
+}
+
+void NormalFlowEstimator::setFieldOutput(int cellSize, Metavision::timestamp period, FieldCallback callback) {
+    if (cellSize <= 0 || period <= 0) {
+        throw std::invalid_argument("NormalFlowEstimator: cellSize and period must be positive");
+    }
+    mFieldPeriod = period;
+    mFieldEnd = 0;
+    mFieldCallback = std::move(callback);
+    mField.cellSize = cellSize;
+    mField.width = (mWidth + cellSize - 1) / cellSize;
+    mField.height = (mHeight + cellSize - 1) / cellSize;
+    const size_t cells = static_cast<size_t>(mField.width) * mField.height;
+    mField.vx.assign(cells, 0.0f);
+    mField.vy.assign(cells, 0.0f);
+    mField.count.assign(cells, 0U);
+    mSumX.assign(cells, 0.0);
+    mSumY.assign(cells, 0.0);
+    mSumCount.assign(cells, 0U);
+}
+
+bool NormalFlowEstimator::fit(const Metavision::EventCD &event, float &vx, float &vy) {
+    const size_t plane = (event.p > 0 ? 1 : 0) * static_cast<size_t>(mWidth) * mHeight;
+    Metavision::timestamp *sae = mSae.data() + plane;
+    const int x0 = std::max(0, event.x - mRadius);
+    const int x1 = std::min(mWidth - 1, event.x + mRadius);
+    const int y0 = std::max(0, event.y - mRadius);
+    const int y1 = std::min(mHeight - 1, event.y + mRadius);
+
+    // 行带外的较晚事件、时间窗口外的事件（含从未触发的 kNoEvent）都不参与拟合；
+    // 当前像素的旧时间戳也跳过，由当前事件作为原点代替
+    const Metavision::timestamp tMin = event.t - mDuration;
+    auto gather = [&](PlaneSums &sums, const auto &accept) {
+        for (int y = y0; y <= y1; ++y) {
+            const Metavision::timestamp *row = sae + static_cast<size_t>(y) * mWidth;
+            const int dy = y - event.y;
+            // 行内用无分支的掩码累积，避免逐点条件分支的预测失败
+            int64_t rn = 0, rx = 0, rxx = 0, rt = 0, rxt = 0;
+            for (int x = x0; x <= x1; ++x) {
+                const Metavision::timestamp t = row[x];
+                const int dx = x - event.x;
+                const bool inWindow = (t <= event.t) & (t >= tMin) & ((dx != 0) | (dy != 0));
+                const int64_t dt = inWindow ? t - event.t : 0;
+                const bool valid = inWindow & accept(dx, dy, dt);
+                rn += valid;
+                rx += valid ? dx : 0;
+                rxx += valid ? dx * dx : 0;
+                rt += valid ? dt : 0;
+                rxt += valid ? dx * dt : 0;
+            }
+            sums.addRow(dy, rn, rx, rxx, rt, rxt);
+        }
+    };
+
+    PlaneSums sums;
+    gather(sums, [](int, int, int64_t) { return true; });
+    ++sums.n;
+    if (sums.n < mMinNeighbors) {
+        sae[static_cast<size_t>(event.y) * mWidth + event.x] = event.t;
+        return false;
+    }
+
+    double a, b, c;
+    bool ok = sums.solve(a, b, c);
+    if (ok && mFitTolerance > 0) {
+        // 剔除残差过大的点后重拟合一次
+        PlaneSums inliers;
+        const double tolerance = mFitTolerance;
+        gather(inliers, [&](int dx, int dy, int64_t dt) {
+            return std::abs(a * dx + b * dy + c - static_cast<double>(dt)) <= tolerance;
+        });
+        ++inliers.n;
+        ok = inliers.n >= mMinNeighbors && inliers.solve(a, b, c);
+    }
+    sae[static_cast<size_t>(event.y) * mWidth + event.x] = event.t;
+    if (!ok) {
+        return false;
+    }
+
+    // (a, b) 为时间梯度（微秒/像素），法向速度为梯度方向上的 1/|g|
+    const double norm2 = a * a + b * b;
+    if (norm2 < 1e-12) {
+        return false;
+    }
+    vx = static_cast<float>(a / norm2 * 1e6);
+    vy = static_cast<float>(b / norm2 * 1e6);
+    return true;
+}
+
+void NormalFlowEstimator::processBand(size_t band) {
+    const Metavision::EventCD *events = mPartitioner.bandEvents(band);
+    const uint32_t *indices = mPartitioner.bandIndices(band);
+    const size_t size = mPartitioner.bandSize(band);
+    for (size_t i = 0; i < size; ++i) {
+        float *flow = &mFlow[2 * static_cast<size_t>(indices[i])];
+        if (!fit(events[i], flow[0], flow[1])) {
+            flow[0] = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+}
+
+void NormalFlowEstimator::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                         std::vector<FlowEvent> &out) {
+    out.clear();
+    const size_t count = static_cast<size_t>(end - begin);
+    if (count == 0) {
+        return;
+    }
+    mFlow.resize(2 * count);
+    mPartitioner.partition(begin, end, mPool.get(), true);
+
+    // 偶数行带与奇数行带分两轮，同一轮内的行带互不相邻
+    const bool parallel = count >= Utils::EventPartitioner::kParallelThreshold;
+    mPartitioner.forEachBandAlternating(parallel ? mPool.get() : nullptr, [this](size_t band) {
+        processBand(band);
+    });
+
+    // 按输入顺序收集结果并累积稠密光流场
+    for (size_t i = 0; i < count; ++i) {
+        const float vx = mFlow[2 * i];
+        if (std::isnan(vx)) {
+            continue;
+        }
+        const Metavision::EventCD &event = begin[i];
+        out.push_back(FlowEvent{event.x, event.y, event.p, event.t, vx, mFlow[2 * i + 1]});
+        if (mFieldPeriod > 0) {
+            accumulateField(out.back());
+        }
+    }
+}
+
+std::vector<FlowEvent> NormalFlowEstimator::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<FlowEvent> flows;
+    process_events(events.data(), events.data() + events.size(), flows);
+    return flows;
+}
+
+void NormalFlowEstimator::accumulateField(const FlowEvent &flow) {
+    if (mFieldEnd == 0) {
+        mFieldEnd = (flow.t / mFieldPeriod + 1) * mFieldPeriod;
+    }
+    while (flow.t >= mFieldEnd) {
+        emitField();
+        mFieldEnd += mFieldPeriod;
+    }
+    const size_t cell = static_cast<size_t>(flow.y / mField.cellSize) * mField.width + flow.x / mField.cellSize;
+    mSumX[cell] += flow.vx;
+    mSumY[cell] += flow.vy;
+    ++mSumCount[cell];
+}
+
+void NormalFlowEstimator::emitField() {
+    mField.t = mFieldEnd;
+    for (size_t cell = 0; cell < mSumCount.size(); ++cell) {
+        const uint32_t n = mSumCount[cell];
+        mField.count[cell] = n;
+        mField.vx[cell] = n > 0 ? static_cast<float>(mSumX[cell] / n) : 0.0f;
+        mField.vy[cell] = n > 0 ? static_cast<float>(mSumY[cell] / n) : 0.0f;
+    }
+    std::fill(mSumX.begin(), mSumX.end(), 0.0);
+    std::fill(mSumY.begin(), mSumY.end(), 0.0);
+    std::fill(mSumCount.begin(), mSumCount.end(), 0U);
+    if (mFieldCallback) {
+        mFieldCallback(mField);
+    }
+}
+
+} // namespace CV
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv3d/event_undistorter.h"
+
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+#include "utils/state_snapshot.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+namespace {
+constexpr uint32_t kCacheTag = Utils::stateTag('U', 'N', 'D', 'L');
+constexpr int kMaxOutputSize = 4096;
+// 查找表只在加载时计算一次，迭代次数多于 cv::undistortPoints 默认的 5 次
+constexpr int kUndistortIterations = 20;
+} // namespace
+
+EventUndistorter::EventUndistorter(
+    int width,
+    int height,
+    const CameraModel &camera,
+    const Eigen::Matrix3d &rectification,
+    const CameraModel &target,
+    int outWidth,
+    int outHeight,
+    const std::string &cachePath
+) :
+    mWidth(width),
+    mHeight(height),
+    mOutWidth(outWidth > 0 ? outWidth : width),
+    mOutHeight(outHeight > 0 ? outHeight : height),
+    mFromCache(false)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("EventUndistorter: width and height must be positive");
+    }
+    if (mOutWidth > kMaxOutputSize || mOutHeight > kMaxOutputSize) {
+        throw std::invalid_argument("EventUndistorter: output size must not exceed 4096");
+    }
+    if (camera.fx <= 0.0 || camera.fy <= 0.0) {
+        throw std::invalid_argument("EventUndistorter: focal lengths must be positive");
+    }
+    const CameraModel &projection = target.fx > 0.0 ? target : camera;
+    mParameters = {static_cast<double>(width), static_cast<double>(height), static_cast<double>(mOutWidth),
+                   static_cast<double>(mOutHeight), camera.fx, camera.fy, camera.cx, camera.cy, camera.k1,
+                   camera.k2, camera.p1, camera.p2, camera.k3, projection.fx, projection.fy, projection.cx,
+                   projection.cy};
+    for (int i = 0; i < 9; ++i) {
+        mParameters.push_back(rectification(i / 3, i % 3));
+    }
+
+    if (!cachePath.empty() && loadCache(cachePath)) {
+        mFromCache = true;
+        return;
+    }
+    build(camera, rectification, projection);
+    if (!cachePath.empty()) {
+        // 缓存只用于加速启动，写入失败不影响使用
+        try {
+            saveCache(cachePath);
+        } catch (const std::exception &) {
+        }
+    }
+}
+
+void EventUndistorter::build(const CameraModel &camera, const Eigen::Matrix3d &rectification,
+                             const CameraModel &target) {
+    mLut.assign(static_cast<size_t>(mWidth) * mHeight, kInvalid);
+    const double scale = static_cast<double>(1 << kFractionBits);
+    for (int y = 0; y < mHeight; ++y) {
+        for (int x = 0; x < mWidth; ++x) {
+            // 迭代求解去畸变的归一化坐标
+            const double x0 = (x - camera.cx) / camera.fx;
+            const double y0 = (y - camera.cy) / camera.fy;
+            double xu = x0;
+            double yu = y0;
+            for (int iteration = 0; iteration < kUndistortIterations; ++iteration) {
+                const double r2 = xu * xu + yu * yu;
+                const double radial = 1.0 + ((camera.k3 * r2 + camera.k2) * r2 + camera.k1) * r2;
+                const double dx = 2.0 * camera.p1 * xu * yu + camera.p2 * (r2 + 2.0 * xu * xu);
+                const double dy = camera.p1 * (r2 + 2.0 * yu * yu) + 2.0 * camera.p2 * xu * yu;
+                xu = (x0 - dx) / radial;
+                yu = (y0 - dy) / radial;
+            }
+            const Eigen::Vector3d ray = rectification * Eigen::Vector3d(xu, yu, 1.0);
+            if (!(ray.z() > 0.0)) {
+                continue;
+            }
+            const double u = target.fx * ray.x() / ray.z() + target.cx;
+            const double v = target.fy * ray.y() / ray.z() + target.cy;
+            if (!(u >= 0.0 && v >= 0.0 && u <= mOutWidth - 1 && v <= mOutHeight - 1)) {
+                continue;
+            }
+            const uint32_t uq = static_cast<uint32_t>(std::lround(u * scale));
+            const uint32_t vq = static_cast<uint32_t>(std::lround(v * scale));
+            mLut[static_cast<size_t>(y) * mWidth + x] = (vq << 16) | uq;
+        }
+    }
+}
+
+void EventUndistorter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                      std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    Metavision::EventCD *dst = out.data();
+    const uint32_t *lut = mLut.data();
+    const uint32_t width = static_cast<uint32_t>(mWidth);
+    const uint32_t height = static_cast<uint32_t>(mHeight);
+    constexpr uint32_t half = 1u << (kFractionBits - 1);
+    size_t count = 0;
+    // 无分支压缩：每个事件都写到当前位置，有效时才前移
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        const bool inside = event->x < width && event->y < height;
+        const uint32_t entry = lut[inside ? static_cast<size_t>(event->y) * width + event->x : 0];
+        const bool valid = inside && entry != kInvalid;
+        Metavision::EventCD &mapped = dst[count];
+        mapped = *event;
+        mapped.x = static_cast<unsigned short>(((entry & 0xFFFFu) + half) >> kFractionBits);
+        mapped.y = static_cast<unsigned short>(((entry >> 16) + half) >> kFractionBits);
+        count += valid ? 1 : 0;
+    }
+    out.resize(count);
+}
+
+std::vector<Metavision::EventCD> EventUndistorter::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> mapped;
+    process_events(events.data(), events.data() + events.size(), mapped);
+    return mapped;
+}
+
+bool EventUndistorter::map(int x, int y, float &u, float &v) const noexcept {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return false;
+    }
+    const uint32_t entry = mLut[static_cast<size_t>(y) * mWidth + x];
+    if (entry == kInvalid) {
+        return false;
+    }
+    const float scale = 1.0f / static_cast<float>(1 << kFractionBits);
+    u = static_cast<float>(entry & 0xFFFFu) * scale;
+    v = static_cast<float>(entry >> 16) * scale;
+    return true;
+}
+
+void EventUndistorter::saveCache(const std::string &path) const {
+    Utils::StateWriter writer(path, kCacheTag);
+    writer.write(mParameters);
+    writer.write(mLut);
+    writer.close();
+}
+
+bool EventUndistorter::loadCache(const std::string &path) {
+    try {
+        Utils::StateReader reader(path, kCacheTag);
+        std::vector<double> parameters;
+        reader.read(parameters);
+        if (parameters != mParameters) {
+            return false;
+        }
+        std::vector<uint32_t> lut;
+        reader.read(lut);
+        if (lut.size() != static_cast<size_t>(mWidth) * mHeight) {
+            return false;
+        }
+        mLut.swap(lut);
+        return true;
+    } catch (const std::exception &) {
+        // 文件不存在或格式不符时重新计算
+        return false;
+    }
+}
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
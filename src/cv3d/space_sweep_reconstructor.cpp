@@ -0,0 +1,318 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv3d/space_sweep_reconstructor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+namespace {
+// 每块事件先统一计算射线再投票，块大小决定射线缓冲区的上限
+constexpr size_t kChunkSize = 1 << 15;
+
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+} // namespace
+
+SpaceSweepReconstructor::SpaceSweepReconstructor(
+    int width,
+    int height,
+    float fx,
+    float fy,
+    float cx,
+    float cy,
+    float minDepth,
+    float maxDepth,
+    int depthPlanes,
+    size_t threads
+) :
+    mWidth(width),
+    mHeight(height),
+    mFx(fx),
+    mFy(fy),
+    mCx(cx),
+    mCy(cy),
+    mPlanes(depthPlanes),
+    mInverseNear(0.0f),
+    mInverseStep(0.0f),
+    mReference{0, Eigen::Quaternionf::Identity(), Eigen::Vector3f::Zero()}
+{
+    if (width <= 1 || height <= 1) {
+        throw std::invalid_argument("SpaceSweepReconstructor: width and height must be greater than 1");
+    }
+    if (fx <= 0.0f || fy <= 0.0f) {
+        throw std::invalid_argument("SpaceSweepReconstructor: focal lengths must be positive");
+    }
+    if (minDepth <= 0.0f || maxDepth <= minDepth) {
+        throw std::invalid_argument("SpaceSweepReconstructor: depth range must satisfy 0 < minDepth < maxDepth");
+    }
+    if (depthPlanes < 2) {
+        throw std::invalid_argument("SpaceSweepReconstructor: at least two depth planes are required");
+    }
+    mInverseNear = 1.0f / minDepth;
+    mInverseStep = (1.0f / minDepth - 1.0f / maxDepth) / static_cast<float>(depthPlanes - 1);
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    initialize();
+}
+
+void SpaceSweepReconstructor::initialize() {
+    mDsi.assign(static_cast<size_t>(mPlanes) * mWidth * mHeight, 0.0f);
+}
+
+void SpaceSweepReconstructor::addPose(const CameraPose &pose) {
+    if (!mTrajectory.empty() && pose.t <= mTrajectory.back().t) {
+        throw std::invalid_argument("SpaceSweepReconstructor: pose timestamps must be strictly increasing");
+    }
+    mTrajectory.push_back(pose);
+    mTrajectory.back().rotation.normalize();
+}
+
+void SpaceSweepReconstructor::clearTrajectory() {
+    mTrajectory.clear();
+}
+
+bool SpaceSweepReconstructor::poseAt(Metavision::timestamp t, CameraPose &pose) const {
+    if (mTrajectory.empty() || t < mTrajectory.front().t || t > mTrajectory.back().t) {
+        return false;
+    }
+    const auto next = std::upper_bound(mTrajectory.begin(), mTrajectory.end(), t,
+                                       [](Metavision::timestamp value, const CameraPose &p) { return value < p.t; });
+    if (next == mTrajectory.end()) {
+        pose = mTrajectory.back();
+        return true;
+    }
+    const CameraPose &a = *(next - 1);
+    const CameraPose &b = *next;
+    const float s = static_cast<float>(t - a.t) / static_cast<float>(b.t - a.t);
+    pose.t = t;
+    pose.rotation = a.rotation.slerp(s, b.rotation);
+    pose.position = a.position + s * (b.position - a.position);
+    return true;
+}
+
+void SpaceSweepReconstructor::setReference(const CameraPose &pose) {
+    mReference = pose;
+    mReference.rotation.normalize();
+    initialize();
+}
+
+void SpaceSweepReconstructor::setReference(Metavision::timestamp t) {
+    CameraPose pose;
+    if (!poseAt(t, pose)) {
+        throw std::invalid_argument("SpaceSweepReconstructor: reference time is outside the trajectory");
+    }
+    setReference(pose);
+}
+
+void SpaceSweepReconstructor::computeRays(const Metavision::EventCD *begin, size_t count) {
+    const Eigen::Matrix3f refRotationT = mReference.rotation.toRotationMatrix().transpose();
+    auto body = [&](size_t first, size_t last) {
+        CameraPose pose;
+        for (size_t i = first; i < last; ++i) {
+            const Metavision::EventCD &event = begin[i];
+            mRayValid[i] = 0;
+            if (!poseAt(event.t, pose)) {
+                continue;
+            }
+            // 事件相机到参考相机的变换
+            const Eigen::Matrix3f rotation = refRotationT * pose.rotation.toRotationMatrix();
+            const Eigen::Vector3f translation = refRotationT * (pose.position - mReference.position);
+            Eigen::Vector3f direction = rotation * Eigen::Vector3f((event.x - mCx) / mFx, (event.y - mCy) / mFy, 1.0f);
+            if (direction.z() <= 1e-6f) {
+                continue;
+            }
+            direction /= direction.z();
+            // 与深度平面 z = 1/w 的交点投影到参考图像：u = fx * (a_x + (T_x - T_z * a_x) * w) + cx
+            Ray &ray = mRays[i];
+            ray.uA = mFx * direction.x() + mCx;
+            ray.uB = mFx * (translation.x() - translation.z() * direction.x());
+            ray.vA = mFy * direction.y() + mCy;
+            ray.vB = mFy * (translation.y() - translation.z() * direction.y());
+            ray.wLimit = translation.z() > 0.0f ? 1.0f / translation.z() : std::numeric_limits<float>::infinity();
+            mRayValid[i] = 1;
+        }
+    };
+    if (mPool) {
+        mPool->parallelFor(0, count, body, 1024);
+    } else {
+        body(0, count);
+    }
+}
+
+void SpaceSweepReconstructor::vote(size_t count, size_t firstPlane, size_t lastPlane) {
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    const float maxU = static_cast<float>(mWidth - 1);
+    const float maxV = static_cast<float>(mHeight - 1);
+    // 平面在外层：同一块内相邻事件的投影位置相近，投票集中在当前平面的局部区域
+    for (size_t plane = firstPlane; plane < lastPlane; ++plane) {
+        const float w = mInverseNear - static_cast<float>(plane) * mInverseStep;
+        float *slice = mDsi.data() + plane * pixels;
+        for (size_t i = 0; i < count; ++i) {
+            const Ray &ray = mRays[i];
+            if (!mRayValid[i] || w >= ray.wLimit) {
+                continue;
+            }
+            const float u = ray.uA + ray.uB * w;
+            const float v = ray.vA + ray.vB * w;
+            if (!(u >= 0.0f && v >= 0.0f && u < maxU && v < maxV)) {
+                continue;
+            }
+            const int x = static_cast<int>(u);
+            const int y = static_cast<int>(v);
+            const float ax = u - static_cast<float>(x);
+            const float ay = v - static_cast<float>(y);
+            float *cell = slice + static_cast<size_t>(y) * mWidth + x;
+            cell[0] += (1.0f - ax) * (1.0f - ay);
+            cell[1] += ax * (1.0f - ay);
+            cell[mWidth] += (1.0f - ax) * ay;
+            cell[mWidth + 1] += ax * ay;
+        }
+    }
+}
+
+size_t SpaceSweepReconstructor::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    size_t voted = 0;
+    for (const Metavision::EventCD *chunk = begin; chunk < end; chunk += std::min<size_t>(kChunkSize, end - chunk)) {
+        const size_t count = std::min<size_t>(kChunkSize, static_cast<size_t>(end - chunk));
+        mRays.resize(count);
+        mRayValid.resize(count);
+        computeRays(chunk, count);
+        // 各线程负责一段深度平面，写入互不重叠
+        auto body = [&](size_t first, size_t last) {
+            vote(count, first, last);
+        };
+        if (mPool) {
+            mPool->parallelFor(0, static_cast<size_t>(mPlanes), body);
+        } else {
+            body(0, static_cast<size_t>(mPlanes));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            voted += mRayValid[i];
+        }
+    }
+    return voted;
+}
+
+size_t SpaceSweepReconstructor::process_events(const std::vector<Metavision::EventCD> &events) {
+    return process_events(events.data(), events.data() + events.size());
+}
+
+void SpaceSweepReconstructor::extract(std::vector<CloudPoint> &cloud, float thresholdOffset, int filterRadius,
+                                      float *depthMap, float *confidenceMap) {
+    cloud.clear();
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    std::vector<float> confidence(pixels);
+    std::vector<int> bestPlane(pixels);
+
+    // 沿参考射线取最大值，按行分块并行，平面在外层保证顺序访存
+    auto argmax = [&](size_t rowBegin, size_t rowEnd) {
+        const size_t first = rowBegin * mWidth;
+        const size_t last = rowEnd * mWidth;
+        std::copy(mDsi.begin() + first, mDsi.begin() + last, confidence.begin() + first);
+        std::fill(bestPlane.begin() + first, bestPlane.begin() + last, 0);
+        for (int plane = 1; plane < mPlanes; ++plane) {
+            const float *slice = mDsi.data() + static_cast<size_t>(plane) * pixels;
+            for (size_t i = first; i < last; ++i) {
+                if (slice[i] > confidence[i]) {
+                    confidence[i] = slice[i];
+                    bestPlane[i] = plane;
+                }
+            }
+        }
+    };
+    if (mPool) {
+        mPool->parallelFor(0, static_cast<size_t>(mHeight), argmax);
+    } else {
+        argmax(0, static_cast<size_t>(mHeight));
+    }
+
+    // 可分离的盒式滤波求局部均值
+    const int radius = std::max(filterRadius, 0);
+    std::vector<float> horizontal(pixels);
+    std::vector<float> mean(pixels);
+    for (int y = 0; y < mHeight; ++y) {
+        const float *row = confidence.data() + static_cast<size_t>(y) * mWidth;
+        for (int x = 0; x < mWidth; ++x) {
+            const int x0 = std::max(0, x - radius);
+            const int x1 = std::min(mWidth - 1, x + radius);
+            float sum = 0.0f;
+            for (int k = x0; k <= x1; ++k) {
+                sum += row[k];
+            }
+            horizontal[static_cast<size_t>(y) * mWidth + x] = sum / static_cast<float>(x1 - x0 + 1);
+        }
+    }
+    for (int y = 0; y < mHeight; ++y) {
+        const int y0 = std::max(0, y - radius);
+        const int y1 = std::min(mHeight - 1, y + radius);
+        for (int x = 0; x < mWidth; ++x) {
+            float sum = 0.0f;
+            for (int k = y0; k <= y1; ++k) {
+                sum += horizontal[static_cast<size_t>(k) * mWidth + x];
+            }
+            mean[static_cast<size_t>(y) * mWidth + x] = sum / static_cast<float>(y1 - y0 + 1);
+        }
+    }
+
+    const Eigen::Matrix3f refRotation = mReference.rotation.toRotationMatrix();
+    for (int y = 0; y < mHeight; ++y) {
+        for (int x = 0; x < mWidth; ++x) {
+            const size_t i = static_cast<size_t>(y) * mWidth + x;
+            if (confidenceMap != nullptr) {
+                confidenceMap[i] = confidence[i];
+            }
+            if (depthMap != nullptr) {
+                depthMap[i] = 0.0f;
+            }
+            const float c = confidence[i];
+            if (c <= 0.0f || c <= mean[i] + thresholdOffset) {
+                continue;
+            }
+            // 相邻平面间的抛物线插值
+            const int plane = bestPlane[i];
+            float offset = 0.0f;
+            if (plane > 0 && plane < mPlanes - 1) {
+                const float lower = mDsi[static_cast<size_t>(plane - 1) * pixels + i];
+                const float upper = mDsi[static_cast<size_t>(plane + 1) * pixels + i];
+                const float curvature = lower - 2.0f * c + upper;
+                if (curvature < 0.0f) {
+                    offset = std::min(0.5f, std::max(-0.5f, 0.5f * (lower - upper) / curvature));
+                }
+            }
+            const float depth = 1.0f / (mInverseNear - (static_cast<float>(plane) + offset) * mInverseStep);
+            if (depthMap != nullptr) {
+                depthMap[i] = depth;
+            }
+            const Eigen::Vector3f point = refRotation * Eigen::Vector3f((x - mCx) / mFx * depth,
+                                                                       (y - mCy) / mFy * depth, depth) +
+                                          mReference.position;
+            cloud.push_back(CloudPoint{point.x(), point.y(), point.z(), c});
+        }
+    }
+}
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
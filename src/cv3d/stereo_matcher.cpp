@@ -0,0 +1,320 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cv3d/stereo_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace CV3D {
+
+namespace {
+// 相对时间戳保持在 [0, 2^30) 内，与哨兵值之差不会溢出 int32
+constexpr Metavision::timestamp kTimeLimit = Metavision::timestamp(1) << 30;
+constexpr int32_t kNoEvent = -(int32_t(1) << 30);
+constexpr Metavision::timestamp kNoDepth = std::numeric_limits<Metavision::timestamp>::min();
+
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+} // namespace
+
+StereoMatcher::StereoMatcher(
+    int width,
+    int height,
+    float focalLength,
+    float baseline,
+    int minDisparity,
+    int maxDisparity,
+    Metavision::timestamp maxTimeDiff,
+    float uniqueness,
+    int rowTolerance,
+    int tileRows,
+    size_t threads
+) :
+    mWidth(width),
+    mHeight(height),
+    mFocalBaseline(focalLength * baseline),
+    mMinDisparity(minDisparity),
+    mMaxDisparity(maxDisparity),
+    mMaxTimeDiff(maxTimeDiff),
+    mUniqueness(uniqueness),
+    mRowTolerance(rowTolerance),
+    // 行带高度不小于 rowTolerance，扫描最多跨越相邻的一个行带
+    mLeftPartitioner(std::max(height, 1),
+                     static_cast<size_t>(std::max(1, height / std::max({tileRows, rowTolerance, 1})))),
+    mRightPartitioner(std::max(height, 1),
+                      static_cast<size_t>(std::max(1, height / std::max({tileRows, rowTolerance, 1})))),
+    mHasBase(false),
+    mBase(0)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("StereoMatcher: width and height must be positive");
+    }
+    if (focalLength <= 0.0f || baseline <= 0.0f) {
+        throw std::invalid_argument("StereoMatcher: focalLength and baseline must be positive");
+    }
+    if (minDisparity < 0 || maxDisparity < minDisparity || maxDisparity > kMaxDisparity) {
+        throw std::invalid_argument("StereoMatcher: disparity range must satisfy 0 <= min <= max <= 1023");
+    }
+    if (maxTimeDiff <= 0 || maxTimeDiff >= kTimeLimit / 2) {
+        throw std::invalid_argument("StereoMatcher: maxTimeDiff out of range");
+    }
+    if (rowTolerance < 0) {
+        throw std::invalid_argument("StereoMatcher: rowTolerance must be non-negative");
+    }
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    initialize();
+}
+
+void StereoMatcher::initialize() {
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    mRightSurface.assign(2 * pixels, kNoEvent);
+    mDepth.assign(pixels, 0.0f);
+    mDepthTime.assign(pixels, kNoDepth);
+    mPending.clear();
+    mHasBase = false;
+    mBase = 0;
+}
+
+void StereoMatcher::rebase(Metavision::timestamp first, Metavision::timestamp last) {
+    if (!mHasBase) {
+        mBase = first - mMaxTimeDiff;
+        mHasBase = true;
+    }
+    if (last - mBase < kTimeLimit) {
+        return;
+    }
+    const Metavision::timestamp base = first - mMaxTimeDiff;
+    if (last - base >= kTimeLimit) {
+        throw std::runtime_error("StereoMatcher: batch spans too long a time range");
+    }
+    // 早于新基准的时间戳已超出 maxTimeDiff，不会再参与匹配
+    const int32_t shift = static_cast<int32_t>(base - mBase);
+    for (int32_t &value : mRightSurface) {
+        value = value < shift ? kNoEvent : value - shift;
+    }
+    mBase = base;
+}
+
+float StereoMatcher::match(const Metavision::EventCD &event) const {
+    const int x1 = event.x - mMinDisparity;
+    if (x1 < 0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    const int x0 = std::max(0, event.x - mMaxDisparity);
+    const int n = x1 - x0 + 1;
+    const int32_t t = static_cast<int32_t>(event.t - mBase);
+    const int32_t *plane = mRightSurface.data() + (event.p > 0 ? 1 : 0) * static_cast<size_t>(mWidth) * mHeight;
+    const int y0 = std::max(0, event.y - mRowTolerance);
+    const int y1 = std::min(mHeight - 1, event.y + mRowTolerance);
+
+    // 以下循环都是定长、无分支的连续访存，编译器可自动向量化
+    int32_t cost[kMaxDisparity + 1];
+    const int32_t *row = plane + static_cast<size_t>(y0) * mWidth + x0;
+    for (int i = 0; i < n; ++i) {
+        cost[i] = std::abs(t - row[i]);
+    }
+    for (int y = y0 + 1; y <= y1; ++y) {
+        row = plane + static_cast<size_t>(y) * mWidth + x0;
+        for (int i = 0; i < n; ++i) {
+            cost[i] = std::min(cost[i], std::abs(t - row[i]));
+        }
+    }
+    int32_t best = std::numeric_limits<int32_t>::max();
+    for (int i = 0; i < n; ++i) {
+        best = std::min(best, cost[i]);
+    }
+    if (best > mMaxTimeDiff) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    int k = 0;
+    while (cost[k] != best) {
+        ++k;
+    }
+
+    // 与最优视差相距超过 1 像素的次优代价
+    int32_t second = std::numeric_limits<int32_t>::max();
+    for (int i = 0; i < k - 1; ++i) {
+        second = std::min(second, cost[i]);
+    }
+    for (int i = k + 2; i < n; ++i) {
+        second = std::min(second, cost[i]);
+    }
+    if (static_cast<float>(second) + 1.0f < mUniqueness * (static_cast<float>(best) + 1.0f)) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // V 形亚像素插值，两侧代价都有效时才插值
+    float offset = 0.0f;
+    if (k > 0 && k < n - 1) {
+        const int32_t lower = cost[k - 1];
+        const int32_t upper = cost[k + 1];
+        const int32_t peak = std::max(lower, upper);
+        if (peak <= mMaxTimeDiff && peak > best) {
+            offset = 0.5f * static_cast<float>(lower - upper) / static_cast<float>(peak - best);
+        }
+    }
+    return static_cast<float>(event.x) - (static_cast<float>(x0 + k) + offset);
+}
+
+void StereoMatcher::processBand(size_t band) {
+    const Metavision::EventCD *left = mLeftPartitioner.bandEvents(band);
+    const uint32_t *indices = mLeftPartitioner.bandIndices(band);
+    const size_t leftSize = mLeftPartitioner.bandSize(band);
+    const Metavision::EventCD *right = mRightPartitioner.bandEvents(band);
+    const size_t rightSize = mRightPartitioner.bandSize(band);
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+
+    auto write = [&](const Metavision::EventCD &event) {
+        mRightSurface[(event.p > 0 ? pixels : 0) + static_cast<size_t>(event.y) * mWidth + event.x] =
+            static_cast<int32_t>(event.t - mBase);
+    };
+
+    size_t next = 0;
+    for (size_t i = 0; i < leftSize; ++i) {
+        const Metavision::EventCD &event = left[i];
+        while (next < rightSize && right[next].t <= event.t + mMaxTimeDiff) {
+            write(right[next++]);
+        }
+        const float disparity = match(event);
+        mDisparity[indices[i]] = disparity;
+        if (!std::isnan(disparity)) {
+            const size_t pixel = static_cast<size_t>(event.y) * mWidth + event.x;
+            mDepth[pixel] = depthFromDisparity(disparity);
+            mDepthTime[pixel] = event.t;
+        }
+    }
+    for (; next < rightSize; ++next) {
+        write(right[next]);
+    }
+}
+
+void StereoMatcher::run(size_t count, const Metavision::EventCD *rightBegin, const Metavision::EventCD *rightEnd,
+                        std::vector<DepthEvent> &out) {
+    out.clear();
+    mDisparity.assign(count, std::numeric_limits<float>::quiet_NaN());
+    const size_t total = count + static_cast<size_t>(rightEnd - rightBegin);
+    Utils::WorkStealingPool *pool = total >= Utils::EventPartitioner::kParallelThreshold ? mPool.get() : nullptr;
+    mLeftPartitioner.partition(mLeft.data(), mLeft.data() + count, pool, true);
+    mRightPartitioner.partition(rightBegin, rightEnd, pool);
+
+    auto body = [this](size_t band) {
+        processBand(band);
+    };
+    const size_t bands = mLeftPartitioner.bandCount();
+    if (mRowTolerance > 0) {
+        // 扫描会读相邻行带，偶数与奇数行带分两轮
+        mLeftPartitioner.forEachBandAlternating(pool, body);
+    } else if (pool != nullptr && bands > 1) {
+        pool->parallelFor(0, bands, [&](size_t first, size_t last) {
+            for (size_t band = first; band < last; ++band) {
+                processBand(band);
+            }
+        }, 1);
+    } else {
+        for (size_t band = 0; band < bands; ++band) {
+            processBand(band);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const float disparity = mDisparity[i];
+        if (std::isnan(disparity)) {
+            continue;
+        }
+        const Metavision::EventCD &event = mLeft[i];
+        out.push_back(DepthEvent{event.x, event.y, event.p, event.t, disparity, depthFromDisparity(disparity)});
+    }
+}
+
+void StereoMatcher::process_events(const Metavision::EventCD *leftBegin, const Metavision::EventCD *leftEnd,
+                                   const Metavision::EventCD *rightBegin, const Metavision::EventCD *rightEnd,
+                                   std::vector<DepthEvent> &out) {
+    mLeft.assign(mPending.begin(), mPending.end());
+    mLeft.insert(mLeft.end(), leftBegin, leftEnd);
+    mPending.clear();
+    if (mLeft.empty() && rightBegin == rightEnd) {
+        out.clear();
+        return;
+    }
+
+    Metavision::timestamp first = std::numeric_limits<Metavision::timestamp>::max();
+    Metavision::timestamp last = std::numeric_limits<Metavision::timestamp>::min();
+    if (!mLeft.empty()) {
+        first = mLeft.front().t;
+        last = mLeft.back().t;
+    }
+    if (rightBegin != rightEnd) {
+        first = std::min(first, rightBegin->t);
+        last = std::max(last, (rightEnd - 1)->t);
+    }
+    rebase(first, last);
+
+    // 右路数据覆盖到 t + maxTimeDiff 的左事件才能匹配；右路长时间无事件时最多推迟 2 * maxTimeDiff
+    Metavision::timestamp watermark = rightBegin != rightEnd ? (rightEnd - 1)->t : last - mMaxTimeDiff;
+    watermark = std::max(watermark, last - mMaxTimeDiff);
+    const size_t ready = static_cast<size_t>(
+        std::upper_bound(mLeft.begin(), mLeft.end(), watermark - mMaxTimeDiff,
+                         [](Metavision::timestamp t, const Metavision::EventCD &event) { return t < event.t; }) -
+        mLeft.begin());
+    run(ready, rightBegin, rightEnd, out);
+    mPending.assign(mLeft.begin() + ready, mLeft.end());
+}
+
+std::vector<DepthEvent> StereoMatcher::process_events(const std::vector<Metavision::EventCD> &left,
+                                                      const std::vector<Metavision::EventCD> &right) {
+    std::vector<DepthEvent> depths;
+    process_events(left.data(), left.data() + left.size(), right.data(), right.data() + right.size(), depths);
+    return depths;
+}
+
+void StereoMatcher::flush(std::vector<DepthEvent> &out) {
+    mLeft.swap(mPending);
+    mPending.clear();
+    if (mLeft.empty()) {
+        out.clear();
+        return;
+    }
+    rebase(mLeft.front().t, mLeft.back().t);
+    run(mLeft.size(), nullptr, nullptr, out);
+}
+
+void StereoMatcher::depthMap(Metavision::timestamp t, Metavision::timestamp maxAge, float *out) {
+    auto body = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const bool recent = mDepthTime[i] != kNoDepth && t - mDepthTime[i] <= maxAge;
+            out[i] = recent ? mDepth[i] : 0.0f;
+        }
+    };
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    if (mPool) {
+        mPool->parallelFor(0, pixels, body);
+    } else {
+        body(0, pixels);
+    }
+}
+
+} // namespace CV3D
+} // namespace Algorithm
+} // namespace Shimeta
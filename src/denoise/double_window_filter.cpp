@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "denoise/double_window_filter.h"
+#include "utils/state_snapshot.h"
 
 namespace Shimeta {
 namespace Algorithm {
@@ -94,16 +95,48 @@ bool DoubleWindowFilter::evaluate(const Metavision::EventCD &event) {
     return isSignal;
 }
 
+void DoubleWindowFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                        std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> DoubleWindowFilter::process_events(const std::vector<Metavision::EventCD> &events) {
     std::vector<Metavision::EventCD> retained_events;
-    for (const auto& event : events) {
-        if (retain(event)) {
-            retained_events.push_back(event);
-        }
-    }
+    process_events(events.data(), events.data() + events.size(), retained_events);
     return retained_events;
 }
 
+void DoubleWindowFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('D', 'W', 'F', 'S'));
+    writer.write(lastRealEvents);
+    writer.write(lastNoiseEvents);
+    writer.close();
+}
+
+void DoubleWindowFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('D', 'W', 'F', 'S'));
+    std::deque<Metavision::EventCD> realEvents;
+    std::deque<Metavision::EventCD> noiseEvents;
+    reader.read(realEvents);
+    reader.read(noiseEvents);
+    // keep only the most recent events if the snapshot was taken with a larger buffer
+    while (realEvents.size() > mBufferSize) {
+        realEvents.pop_front();
+    }
+    while (noiseEvents.size() > mBufferSize) {
+        noiseEvents.pop_front();
+    }
+    // commit only once both windows have been read, so a bad file leaves the filter untouched
+    lastRealEvents.swap(realEvents);
+    lastNoiseEvents.swap(noiseEvents);
+}
+
 } // namespace Denoise
 } // namespace Algorithm
 } // namespace Shimeta
\ No newline at end of file
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "denoise/event_flow_filter.h"
+#include "utils/state_snapshot.h"
 
 namespace Shimeta {
 namespace Algorithm {
@@ -83,16 +84,40 @@ bool EventFlowFilter::evaluate(const Metavision::EventCD &event) {
     return isSignal;
 }
 
+void EventFlowFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                     std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> EventFlowFilter::process_events(const std::vector<Metavision::EventCD> &events) {
     std::vector<Metavision::EventCD> retained_events;
-    for (const auto& event : events) {
-        if (retain(event)) {
-            retained_events.push_back(event);
-        }
-    }
+    process_events(events.data(), events.data() + events.size(), retained_events);
     return retained_events;
 }
 
+void EventFlowFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('E', 'F', 'F', 'S'));
+    writer.write(mDeque);
+    writer.close();
+}
+
+void EventFlowFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('E', 'F', 'F', 'S'));
+    std::deque<Metavision::EventCD> events;
+    reader.read(events);
+    // 快照的缓冲区较大时只保留最新的事件
+    while (events.size() > mBufferSize) {
+        events.pop_front();
+    }
+    mDeque.swap(events);
+}
+
 } // namespace Denoise
 } // namespace Algorithm
 } // namespace Shimeta
\ No newline at end of file
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "denoise/hot_pixel_filter.h"
+#include "utils/state_snapshot.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+namespace {
+constexpr uint32_t kMaskMagic   = 0x4D505648; // "HVPM"
+constexpr uint32_t kMaskVersion = 1;
+} // namespace
+
+HotPixelFilter::HotPixelFilter(
+    int width,
+    int height,
+    double hotRateThreshold,
+    double deadRateThreshold,
+    int64_t learningDuration,
+    bool continuousLearning
+) :
+    mWidth(width),
+    mHeight(height),
+    mHotRateThreshold(hotRateThreshold),
+    mDeadRateThreshold(deadRateThreshold),
+    mLearningDuration(learningDuration),
+    mContinuousLearning(continuousLearning)
+{
+    initialize();
+}
+
+void HotPixelFilter::initialize() {
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    mMask.assign((pixels + 63) / 64, 0);
+    mEventCounts.assign(pixels, 0);
+    mWindowStart = -1;
+    mLearning = true;
+    mHotPixelCount = 0;
+    mDeadPixelCount = 0;
+}
+
+void HotPixelFilter::accumulate(const Metavision::EventCD &event) {
+    if (mWindowStart < 0) {
+        mWindowStart = event.t;
+    } else if (event.t - mWindowStart >= mLearningDuration) {
+        updateMask(event.t - mWindowStart);
+        if (!mContinuousLearning) {
+            return;
+        }
+        mWindowStart = event.t;
+    }
+    uint32_t &count = mEventCounts[index(event.x, event.y)];
+    if (count != std::numeric_limits<uint32_t>::max()) {
+        ++count;
+    }
+}
+
+void HotPixelFilter::learn(const std::vector<Metavision::EventCD> &events) {
+    for (const auto &event : events) {
+        uint32_t &count = mEventCounts[index(event.x, event.y)];
+        if (count != std::numeric_limits<uint32_t>::max()) {
+            ++count;
+        }
+    }
+}
+
+void HotPixelFilter::updateMask(int64_t duration) {
+    if (duration <= 0) {
+        return;
+    }
+
+    // 将事件率阈值换算为窗口内的事件计数阈值
+    const double seconds = static_cast<double>(duration) * 1e-6;
+    const double hotCount = mHotRateThreshold * seconds;
+    const double deadCount = mDeadRateThreshold * seconds;
+
+    std::fill(mMask.begin(), mMask.end(), 0);
+    mHotPixelCount = 0;
+    mDeadPixelCount = 0;
+    for (size_t i = 0; i < mEventCounts.size(); ++i) {
+        const double count = static_cast<double>(mEventCounts[i]);
+        bool masked = false;
+        if (count >= hotCount) {
+            ++mHotPixelCount;
+            masked = true;
+        } else if (count < deadCount) {
+            ++mDeadPixelCount;
+            masked = true;
+        }
+        if (masked) {
+            mMask[i >> 6] |= uint64_t(1) << (i & 63);
+        }
+    }
+
+    std::fill(mEventCounts.begin(), mEventCounts.end(), 0);
+    mWindowStart = -1;
+    mLearning = false;
+}
+
+void HotPixelFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                    std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
+std::vector<Metavision::EventCD> HotPixelFilter::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> retained_events;
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+void HotPixelFilter::setMasked(int x, int y, bool masked) {
+    const size_t i = index(x, y);
+    if (masked) {
+        mMask[i >> 6] |= uint64_t(1) << (i & 63);
+    } else {
+        mMask[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+}
+
+void HotPixelFilter::saveMask(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open mask file for writing: " + path);
+    }
+    const int32_t header[6] = {
+        static_cast<int32_t>(kMaskMagic), static_cast<int32_t>(kMaskVersion), mWidth, mHeight,
+        static_cast<int32_t>(mHotPixelCount), static_cast<int32_t>(mDeadPixelCount)
+    };
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(mMask.data()), mMask.size() * sizeof(uint64_t));
+    if (!file) {
+        throw std::runtime_error("Failed to write mask file: " + path);
+    }
+}
+
+void HotPixelFilter::loadMask(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open mask file: " + path);
+    }
+    int32_t header[6] = {0, 0, 0, 0, 0, 0};
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    if (!file || static_cast<uint32_t>(header[0]) != kMaskMagic || static_cast<uint32_t>(header[1]) != kMaskVersion) {
+        throw std::runtime_error("Invalid mask file: " + path);
+    }
+    if (header[2] != mWidth || header[3] != mHeight) {
+        throw std::invalid_argument("Mask geometry does not match sensor: " + path);
+    }
+
+    std::vector<uint64_t> mask(mMask.size());
+    file.read(reinterpret_cast<char *>(mask.data()), mask.size() * sizeof(uint64_t));
+    if (!file) {
+        throw std::runtime_error("Truncated mask file: " + path);
+    }
+    mMask.swap(mask);
+
+    mHotPixelCount = static_cast<size_t>(header[4]);
+    mDeadPixelCount = static_cast<size_t>(header[5]);
+    std::fill(mEventCounts.begin(), mEventCounts.end(), 0);
+    mWindowStart = -1;
+    mLearning = false;
+}
+
+void HotPixelFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('H', 'P', 'F', 'S'));
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.write(mMask);
+    writer.write(mEventCounts);
+    writer.writeValue<int64_t>(mWindowStart);
+    writer.writeValue<uint8_t>(mLearning);
+    writer.writeValue<uint64_t>(mHotPixelCount);
+    writer.writeValue<uint64_t>(mDeadPixelCount);
+    writer.close();
+}
+
+void HotPixelFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('H', 'P', 'F', 'S'));
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    std::vector<uint64_t> mask;
+    std::vector<uint32_t> eventCounts;
+    reader.read(mask);
+    reader.read(eventCounts);
+    if (mask.size() != mMask.size() || eventCounts.size() != mEventCounts.size()) {
+        throw std::invalid_argument("HotPixelFilter: state size does not match filter geometry: " + path);
+    }
+    const int64_t windowStart = reader.readValue<int64_t>();
+    const bool learning = reader.readValue<uint8_t>() != 0;
+    const uint64_t hotPixelCount = reader.readValue<uint64_t>();
+    const uint64_t deadPixelCount = reader.readValue<uint64_t>();
+    // 所有段都读取成功后再提交，失败时保持原状态
+    mMask.swap(mask);
+    mEventCounts.swap(eventCounts);
+    mWindowStart = windowStart;
+    mLearning = learning;
+    mHotPixelCount = static_cast<size_t>(hotPixelCount);
+    mDeadPixelCount = static_cast<size_t>(deadPixelCount);
+}
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
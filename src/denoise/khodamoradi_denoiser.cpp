@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "denoise/khodamoradi_denoiser.h"
+#include "utils/state_snapshot.h"
 
 namespace Shimeta {
 namespace Algorithm {
@@ -35,13 +36,20 @@ void KhodamoradiDenoiser::initialize() {
     std::fill(last_event_y_.begin(), last_event_y_.end(), Metavision::EventCD());
 }
 
+void KhodamoradiDenoiser::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                         std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> KhodamoradiDenoiser::process_events(const std::vector<Metavision::EventCD> &events) {
     std::vector<Metavision::EventCD> retained_events;
-    for (const auto &event : events) {
-        if (filter(event)) {
-            retained_events.push_back(event);
-        }
-    }
+    process_events(events.data(), events.data() + events.size(), retained_events);
     return retained_events;
 }
 
@@ -119,6 +127,30 @@ bool KhodamoradiDenoiser::filter(const Metavision::EventCD& event) {
     return isSignal;
 }
 
+void KhodamoradiDenoiser::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('K', 'H', 'D', 'S'));
+    writer.writeValue<int32_t>(width_);
+    writer.writeValue<int32_t>(height_);
+    writer.write(last_event_x_);
+    writer.write(last_event_y_);
+    writer.close();
+}
+
+void KhodamoradiDenoiser::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('K', 'H', 'D', 'S'));
+    reader.expectValue<int32_t>(width_, "width");
+    reader.expectValue<int32_t>(height_, "height");
+    std::vector<Metavision::EventCD> lastEventX;
+    std::vector<Metavision::EventCD> lastEventY;
+    reader.read(lastEventX);
+    reader.read(lastEventY);
+    if (lastEventX.size() != last_event_x_.size() || lastEventY.size() != last_event_y_.size()) {
+        throw std::invalid_argument("KhodamoradiDenoiser: state size does not match filter geometry: " + path);
+    }
+    last_event_x_.swap(lastEventX);
+    last_event_y_.swap(lastEventY);
+}
+
 } // namespace Denoise
 } // namespace Algorithm
 } // namespace Shimeta
\ No newline at end of file
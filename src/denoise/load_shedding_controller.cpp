@@ -0,0 +1,155 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "denoise/load_shedding_controller.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+namespace {
+// 指数滑动平均系数
+constexpr double kSmoothing = 0.2;
+
+inline void smooth(double &value, double sample) {
+    value += kSmoothing * (sample - value);
+}
+} // namespace
+
+LoadSheddingController::LoadSheddingController(
+    int64_t latencyBudget,
+    double degradeRatio,
+    double recoverRatio,
+    size_t recoverBatches
+) :
+    mLatencyBudget(latencyBudget),
+    mDegradeRatio(degradeRatio),
+    mRecoverRatio(recoverRatio),
+    mRecoverBatches(recoverBatches)
+{
+    initialize();
+}
+
+size_t LoadSheddingController::addLevel(const std::string &name, Stage stage) {
+    mLevels.push_back({name, std::move(stage), -1.0});
+    return mLevels.size() - 1;
+}
+
+void LoadSheddingController::setModeSwitchCallback(ModeSwitchCallback callback) {
+    mCallback = std::move(callback);
+}
+
+void LoadSheddingController::initialize() {
+    mLevel = 0;
+    mCalmBatches = 0;
+    mSwitchCount = 0;
+    mLastEventTime = -1;
+    mBacklog = 0.0;
+    mLatency = 0.0;
+    mInputRate = 0.0;
+    mUtilization = 0.0;
+    for (auto &level : mLevels) {
+        level.costPerEvent = -1.0;
+    }
+}
+
+void LoadSheddingController::switchTo(size_t level, Metavision::timestamp t) {
+    ModeSwitch record{mLevel, level, mLevels[mLevel].name, mLevels[level].name, t, mInputRate, mUtilization, mLatency};
+    mLevel = level;
+    mCalmBatches = 0;
+    ++mSwitchCount;
+    if (mCallback) {
+        mCallback(record);
+    }
+}
+
+std::vector<Metavision::EventCD> LoadSheddingController::process_events(const std::vector<Metavision::EventCD> &events) {
+    if (mLevels.empty()) {
+        return events;
+    }
+    if (events.empty()) {
+        return {};
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Metavision::EventCD> retained_events = mLevels[mLevel].stage(events);
+    const double processing = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    // 本批覆盖的传感器时间
+    const Metavision::timestamp last = events.back().t;
+    int64_t span = (mLastEventTime < 0) ? last - events.front().t : last - mLastEventTime;
+    span = std::max<int64_t>(span, 1);
+    mLastEventTime = last;
+
+    const double count = static_cast<double>(events.size());
+    smooth(mInputRate, count * 1e6 / span);
+    smooth(mUtilization, processing / span);
+    double &cost = mLevels[mLevel].costPerEvent;
+    if (cost < 0) {
+        cost = processing / count;
+    } else {
+        smooth(cost, processing / count);
+    }
+
+    // 处理比传感器时间慢的部分会累积为积压，延迟 = 积压 + 本批处理耗时
+    mBacklog = std::max(0.0, mBacklog + processing - span);
+    mLatency = mBacklog + processing;
+
+    const double budget = static_cast<double>(mLatencyBudget);
+    if (mLatency > budget * mDegradeRatio) {
+        mCalmBatches = 0;
+        if (mLevel + 1 < mLevels.size()) {
+            switchTo(mLevel + 1, last);
+        }
+    } else if (mLevel > 0 && mLatency < budget * mRecoverRatio) {
+        // 用上一级别的单事件耗时预测其延迟，只有利用率低于 1（积压不会持续增长）且预计延迟不会再次触发降级时才恢复
+        const double upperCost = mLevels[mLevel - 1].costPerEvent;
+        const double upperProcessing = upperCost * count;
+        const double predicted = std::max(0.0, mBacklog + upperProcessing - span) + upperProcessing;
+        const bool sustainable = upperCost * mInputRate * 1e-6 < 1.0;
+        if (upperCost < 0 || (sustainable && predicted < budget * mDegradeRatio)) {
+            if (++mCalmBatches >= mRecoverBatches) {
+                switchTo(mLevel - 1, last);
+            }
+        } else {
+            mCalmBatches = 0;
+        }
+    } else {
+        mCalmBatches = 0;
+    }
+
+    return retained_events;
+}
+
+std::vector<Metavision::EventCD> LoadSheddingController::subsample(const std::vector<Metavision::EventCD> &events, int stride) {
+    if (stride <= 1) {
+        return events;
+    }
+    std::vector<Metavision::EventCD> retained_events;
+    retained_events.reserve(events.size() / (stride * stride) + 1);
+    for (const auto &event : events) {
+        if (event.x % stride == 0 && event.y % stride == 0) {
+            retained_events.push_back(event);
+        }
+    }
+    return retained_events;
+}
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
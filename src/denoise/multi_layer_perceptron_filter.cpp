@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "denoise/multi_layer_perceptron_filter.h"
+#include "utils/state_snapshot.h"
 #include <string>
 #include <stdexcept>
 
@@ -27,7 +28,8 @@ MultiLayerPerceptronFilter::MultiLayerPerceptronFilter(
     const size_t batchSize,
     const int64_t duration,
     const double floatThreshold,
-    const std::string &device
+    const std::string &device,
+    const Utils::SurfaceLayout layout
 ) :
     mWidth(resolution.first),
     mHeight(resolution.second),
@@ -36,6 +38,7 @@ MultiLayerPerceptronFilter::MultiLayerPerceptronFilter(
     mBatchSize(batchSize),
     mDuration(duration),
     mFloatThreshold(floatThreshold),
+    mTimeSurface(resolution.first, resolution.second, layout),
     mDevice(parseDeviceString(device))
 {
     initialize();
@@ -98,16 +101,7 @@ void MultiLayerPerceptronFilter::initialize() {
 }
 
 void MultiLayerPerceptronFilter::initializeTimeSurface() {
-    mTimeSurface.resize(mWidth);
-    for (auto& column : mTimeSurface) {
-        column.resize(mHeight);
-        for (auto& event : column) {
-            event.x = 0;
-            event.y = 0;
-            event.p = 0;
-            event.t = 0;
-        }
-    }
+    mTimeSurface.fill(Metavision::EventCD(0, 0, 0, 0));
 }
 
 void MultiLayerPerceptronFilter::initializeOffsets() {
@@ -154,7 +148,7 @@ torch::Tensor MultiLayerPerceptronFilter::buildInputTensor(const std::vector<Met
                 single[k + mInputArea] = 0.0;
             } else {
                 // Get the last event at this pixel
-                const auto &lastEvent = mTimeSurface[x][y];
+                const auto &lastEvent = mTimeSurface(x, y);
                 
                 // Calculate temporal feature
                 if (lastEvent.t != 0) {
@@ -171,19 +165,17 @@ torch::Tensor MultiLayerPerceptronFilter::buildInputTensor(const std::vector<Met
         inputTensor[batchInd] = torch::from_blob(single.data(), {mInputVolume}, torch::kFloat);
         
         // Update time surface
-        mTimeSurface[event.x][event.y] = event;
+        mTimeSurface(event.x, event.y) = event;
     }
 
     return inputTensor;
 }
 
-std::vector<Metavision::EventCD> MultiLayerPerceptronFilter::processBatch(const std::vector<Metavision::EventCD> &events) {
-    std::vector<Metavision::EventCD> retainedEvents;
-    
-    if (!mModelIsLoad || events.empty()) {
-        return retainedEvents;
+void MultiLayerPerceptronFilter::classifyBatch(const std::vector<Metavision::EventCD> &events, uint8_t *mask) {
+    if (events.empty()) {
+        return;
     }
-    
+
     try {
         // Build input tensor
         torch::Tensor inputTensor = buildInputTensor(events);
@@ -191,15 +183,30 @@ std::vector<Metavision::EventCD> MultiLayerPerceptronFilter::processBatch(const
         // Forward pass through neural network
         torch::Tensor outputTensor = mPreTrainedModel.forward({inputTensor.to(mDevice)}).toTensor().to(torch::kCPU);
         
-        // Filter events based on neural network output
-        for (size_t i = 0; i < events.size() && i < static_cast<size_t>(outputTensor.size(0)); ++i) {
-            if (outputTensor[i][0].item<double>() >= mFloatThreshold) {
-                retainedEvents.push_back(events[i]);
-            }
+        // Classify events based on neural network output
+        const size_t outputs = static_cast<size_t>(outputTensor.size(0));
+        for (size_t i = 0; i < events.size(); ++i) {
+            mask[i] = (i < outputs && outputTensor[i][0].item<double>() >= mFloatThreshold) ? 1 : 0;
         }
     } catch (const std::exception& e) {
-        // If neural network fails, return all events (fail-safe mode)
-        return events;
+        // If neural network fails, keep all events (fail-safe mode)
+        std::fill(mask, mask + events.size(), 1);
+    }
+}
+
+std::vector<Metavision::EventCD> MultiLayerPerceptronFilter::processBatch(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> retainedEvents;
+    
+    if (!mModelIsLoad || events.empty()) {
+        return retainedEvents;
+    }
+    
+    std::vector<uint8_t> mask(events.size(), 0);
+    classifyBatch(events, mask.data());
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (mask[i]) {
+            retainedEvents.push_back(events[i]);
+        }
     }
     
     return retainedEvents;
@@ -229,24 +236,75 @@ bool MultiLayerPerceptronFilter::evaluate(const Metavision::EventCD &event) {
     return true;
 }
 
+void MultiLayerPerceptronFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                                std::vector<Metavision::EventCD> &out) {
+    const size_t count = static_cast<size_t>(end - begin);
+    if (!mModelIsLoad) {
+        // If model is not loaded, return all events
+        out.assign(begin, end);
+        return;
+    }
+
+    // Process events in batches, reusing the batch copy and mask across calls
+    out.resize(count);
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i += mBatchSize) {
+        const size_t endIdx = std::min<size_t>(i + mBatchSize, count);
+        mBatch.assign(begin + i, begin + endIdx);
+        mMask.assign(mBatch.size(), 0);
+        classifyBatch(mBatch, mMask.data());
+        for (size_t j = 0; j < mBatch.size(); ++j) {
+            out[kept] = mBatch[j];
+            kept += mMask[j] ? 1 : 0;
+        }
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> MultiLayerPerceptronFilter::process_events(const std::vector<Metavision::EventCD> &events) {
     std::vector<Metavision::EventCD> retainedEvents;
-    
+    process_events(events.data(), events.data() + events.size(), retainedEvents);
+    return retainedEvents;
+}
+
+std::vector<uint8_t> MultiLayerPerceptronFilter::classify_events(const std::vector<Metavision::EventCD> &events) {
+    // If model is not loaded, keep all events
+    std::vector<uint8_t> mask(events.size(), 1);
     if (!mModelIsLoad) {
-        // If model is not loaded, return all events
-        return events;
+        return mask;
     }
-    
-    // Process events in batches
+
+    // Classify events in batches
+    std::vector<Metavision::EventCD> batch;
     for (size_t i = 0; i < events.size(); i += mBatchSize) {
         size_t endIdx = std::min(i + mBatchSize, events.size());
-        std::vector<Metavision::EventCD> batch(events.begin() + i, events.begin() + endIdx);
-        
-        auto batchResults = processBatch(batch);
-        retainedEvents.insert(retainedEvents.end(), batchResults.begin(), batchResults.end());
+        batch.assign(events.begin() + i, events.begin() + endIdx);
+        classifyBatch(batch, mask.data() + i);
     }
-    
-    return retainedEvents;
+
+    return mask;
+}
+
+void MultiLayerPerceptronFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('M', 'L', 'P', 'S'));
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.write(mTimeSurface.columns());
+    writer.write(mEventBuffer);
+    writer.close();
+}
+
+void MultiLayerPerceptronFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('M', 'L', 'P', 'S'));
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    std::vector<Metavision::EventCD> surface;
+    reader.read(surface);
+    decltype(mEventBuffer) eventBuffer;
+    reader.read(eventBuffer);
+    // validate every section before touching the filter so a bad file leaves it untouched
+    mTimeSurface.assignColumns(surface);
+    mEventBuffer.swap(eventBuffer);
 }
 
 } // namespace Denoise
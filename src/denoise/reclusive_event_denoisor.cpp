@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "denoise/reclusive_event_denoisor.h"
+#include "utils/state_snapshot.h"
 #include <algorithm>
 #include <limits>
 
@@ -21,50 +22,84 @@ namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
 
-ReclusiveEventDenoisor::ReclusiveEventDenoisor(int width, int height, int tau, int n)
+ReclusiveEventDenoisor::ReclusiveEventDenoisor(int width, int height, int tau, int n, Utils::SurfaceLayout layout)
     : width_(width), height_(height), tau_(tau), n_(n),
-      last_event_time_on_(width, std::vector<int64_t>(height, std::numeric_limits<int64_t>::min())),
-      last_event_time_off_(width, std::vector<int64_t>(height, std::numeric_limits<int64_t>::min())) {}
+      last_event_time_on_(width, height, layout, std::numeric_limits<int64_t>::min()),
+      last_event_time_off_(width, height, layout, std::numeric_limits<int64_t>::min()) {}
 
 void ReclusiveEventDenoisor::reset() {
-    std::fill(last_event_time_on_.begin(), last_event_time_on_.end(), std::vector<int64_t>(height_, std::numeric_limits<int64_t>::min()));
-    std::fill(last_event_time_off_.begin(), last_event_time_off_.end(), std::vector<int64_t>(height_, std::numeric_limits<int64_t>::min()));
+    last_event_time_on_.fill(std::numeric_limits<int64_t>::min());
+    last_event_time_off_.fill(std::numeric_limits<int64_t>::min());
 }
 
-std::vector<Metavision::EventCD> ReclusiveEventDenoisor::process_events(const std::vector<Metavision::EventCD> &events) {
-    std::vector<Metavision::EventCD> denoised_events;
-    for (const auto &ev : events) {
-        int x = ev.x;
-        int y = ev.y;
-        int p = ev.p;
-        int64_t t = ev.t;
-        bool is_signal = false;
-        // 检查空间邻域内是否有同极性事件在tau时间内发生
-        for (int dx = -n_; dx <= n_; ++dx) {
-            for (int dy = -n_; dy <= n_; ++dy) {
-                int nx = x + dx;
-                int ny = y + dy;
-                if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_)
-                    continue;
-                int64_t last_t = (p == 1) ? last_event_time_on_[nx][ny] : last_event_time_off_[nx][ny];
-                if (t - last_t <= tau_) {
-                    is_signal = true;
-                    break;
-                }
+bool ReclusiveEventDenoisor::evaluate(const Metavision::EventCD &ev) {
+    int x = ev.x;
+    int y = ev.y;
+    int p = ev.p;
+    int64_t t = ev.t;
+    bool is_signal = false;
+    auto &surface = (p == 1) ? last_event_time_on_ : last_event_time_off_;
+    const int64_t *last_time = surface.data();
+    const uint32_t *columns = surface.index().columnOffsets();
+    const uint32_t *rows = surface.index().rowOffsets();
+    // 检查空间邻域内是否有同极性事件在tau时间内发生
+    const int y0 = std::max(0, y - n_);
+    const int y1 = std::min(height_ - 1, y + n_);
+    for (int nx = std::max(0, x - n_); nx <= std::min(width_ - 1, x + n_) && !is_signal; ++nx) {
+        const int64_t *column = last_time + columns[nx];
+        for (int ny = y0; ny <= y1; ++ny) {
+            if (t - column[rows[ny]] <= tau_) {
+                is_signal = true;
+                break;
             }
-            if (is_signal) break;
-        }
-        // 更新当前像素的最后事件时间
-        if (p == 1) {
-            last_event_time_on_[x][y] = t;
-        } else {
-            last_event_time_off_[x][y] = t;
-        }
-        if (is_signal) {
-            denoised_events.push_back(ev);
         }
     }
-    return denoised_events;
+    // 更新当前像素的最后事件时间
+    surface(x, y) = t;
+    return is_signal;
+}
+
+void ReclusiveEventDenoisor::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                            std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
+std::vector<Metavision::EventCD> ReclusiveEventDenoisor::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> retained_events;
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+void ReclusiveEventDenoisor::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('R', 'E', 'D', 'S'));
+    writer.writeValue<int32_t>(width_);
+    writer.writeValue<int32_t>(height_);
+    writer.write(last_event_time_on_.columns());
+    writer.write(last_event_time_off_.columns());
+    writer.close();
+}
+
+void ReclusiveEventDenoisor::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('R', 'E', 'D', 'S'));
+    reader.expectValue<int32_t>(width_, "width");
+    reader.expectValue<int32_t>(height_, "height");
+    std::vector<int64_t> onColumns;
+    std::vector<int64_t> offColumns;
+    reader.read(onColumns);
+    reader.read(offColumns);
+    // 快照按列主序保存 width*height 个像素，与表面布局（及其填充）无关
+    const size_t pixels = static_cast<size_t>(width_) * height_;
+    if (onColumns.size() != pixels || offColumns.size() != pixels) {
+        throw std::invalid_argument("ReclusiveEventDenoisor: state size does not match filter geometry: " + path);
+    }
+    last_event_time_on_.assignColumns(onColumns);
+    last_event_time_off_.assignColumns(offColumns);
 }
 
 } // namespace Denoise
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "denoise/refractory_filter.h"
+#include "utils/state_snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Denoise {
+
+namespace {
+constexpr int kTimeBits = 24;
+constexpr int64_t kTimeLimit = int64_t(1) << kTimeBits;
+// 平移后新基准距当前时刻的距离；相对时刻 0 表示至少这么久以前
+constexpr int64_t kHorizon = kTimeLimit >> 1;
+constexpr uint32_t kTokenMask = 0xFF;
+constexpr uint32_t kTokenUnit = 16; // 一个令牌 = 16 个 1/16 令牌
+
+/// 判断像素上的事件并更新状态字。Limited 为 false 时只检查死区，令牌数保持满桶
+template <bool Limited>
+inline bool admit(uint32_t &state, uint32_t now, uint32_t deadTicks, uint64_t refillQ32, uint32_t capacity) {
+    const uint32_t last = state >> (32 - kTimeBits);
+    // 同一像素时间倒退时按零间隔处理
+    const uint32_t elapsed = now > last ? now - last : 0;
+    uint32_t tokens = capacity;
+    uint32_t carry = 0;
+    bool keep = elapsed >= deadTicks;
+    if (Limited) {
+        const uint64_t scaled = static_cast<uint64_t>(elapsed) * refillQ32;
+        const uint64_t level = (state & kTokenMask) + (scaled >> 32);
+        tokens = static_cast<uint32_t>(std::min<uint64_t>(capacity, level));
+        // 不足 1/16 令牌的余量折算为时间，记录的时刻相应提前，留到下次补充；桶满时余量作废
+        carry = level < capacity ? static_cast<uint32_t>((scaled & 0xFFFFFFFFu) / refillQ32) : 0;
+        keep &= tokens >= kTokenUnit;
+        tokens -= kTokenUnit;
+    }
+    // 判定结果难以预测，用条件选择代替分支
+    state = keep ? ((now - carry) << (32 - kTimeBits)) | tokens : state;
+    return keep;
+}
+
+/// 批量处理一段事件，返回保留的事件数。参数按值传入：状态字与成员同为 uint32_t，
+/// 经 this 访问的限额在每次写状态后都要重新读取
+template <bool Limited>
+size_t admitRange(const Metavision::EventCD *begin, const Metavision::EventCD *end, Metavision::EventCD *out,
+                  uint32_t *state, size_t width, int64_t base, uint32_t deadTicks, uint64_t refillQ32,
+                  uint32_t capacity) {
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += admit<Limited>(state[static_cast<size_t>(event->y) * width + event->x],
+                               static_cast<uint32_t>(event->t - base), deadTicks, refillQ32, capacity) ? 1 : 0;
+    }
+    return kept;
+}
+} // namespace
+
+RefractoryFilter::RefractoryFilter(
+    int width,
+    int height,
+    int64_t deadTime,
+    double maxRate,
+    int burstSize
+) :
+    mWidth(width),
+    mHeight(height),
+    mDeadTime(deadTime),
+    mMaxRate(maxRate),
+    mBurstSize(burstSize)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("RefractoryFilter: width and height must be positive");
+    }
+    if (deadTime < 0 || deadTime >= kHorizon) {
+        throw std::invalid_argument("RefractoryFilter: deadTime must be in [0, 2^23) us");
+    }
+    if (burstSize < 1 || burstSize > 15) {
+        throw std::invalid_argument("RefractoryFilter: burstSize must be in [1, 15]");
+    }
+    if (maxRate < 0.0 || maxRate > 1e6) {
+        throw std::invalid_argument("RefractoryFilter: maxRate must be in [0, 1e6] events/s");
+    }
+    // 空闲超过时间范围的像素按满桶处理，因此填满令牌桶的时间不能超过该范围
+    if (maxRate > 0.0 && burstSize * 1e6 / maxRate >= static_cast<double>(kHorizon)) {
+        throw std::invalid_argument("RefractoryFilter: maxRate is too low to refill burstSize tokens within 2^23 us");
+    }
+    mDeadTicks = static_cast<uint32_t>(deadTime);
+    mRefillQ32 = maxRate > 0.0 ? static_cast<uint64_t>(std::llround(kTokenUnit * maxRate * 1e-6 * 4294967296.0)) : 0;
+    mCapacity = static_cast<uint32_t>(burstSize) * kTokenUnit;
+    initialize();
+}
+
+void RefractoryFilter::initialize() {
+    // 相对时刻 0 且满桶，即足够久以前的保留事件
+    mState.assign(static_cast<size_t>(mWidth) * mHeight, mCapacity);
+    mBase = 0;
+    mHasBase = false;
+    mProcessed = 0;
+    mRejected = 0;
+}
+
+void RefractoryFilter::rebase(int64_t t) {
+    const int64_t base = t - kHorizon;
+    if (!mHasBase) {
+        mBase = base;
+        mHasBase = true;
+        return;
+    }
+    const int64_t shift = base - mBase;
+    if (shift <= 0) {
+        return;
+    }
+    for (uint32_t &state : mState) {
+        const int64_t last = static_cast<int64_t>(state >> (32 - kTimeBits)) - shift;
+        // 平移到基准之前的像素已空闲超过时间范围，令牌桶视为已满
+        state = last > 0 ? (static_cast<uint32_t>(last) << (32 - kTimeBits)) | (state & kTokenMask) : mCapacity;
+    }
+    mBase = base;
+}
+
+bool RefractoryFilter::evaluate(const Metavision::EventCD &event) {
+    if (!mHasBase || event.t - mBase >= kTimeLimit) {
+        rebase(event.t);
+    }
+    uint32_t &state = mState[static_cast<size_t>(event.y) * mWidth + event.x];
+    const uint32_t now = static_cast<uint32_t>(std::max<int64_t>(event.t - mBase, 0));
+    const bool keep = mRefillQ32 != 0 ? admit<true>(state, now, mDeadTicks, mRefillQ32, mCapacity)
+                                      : admit<false>(state, now, mDeadTicks, mRefillQ32, mCapacity);
+    ++mProcessed;
+    mRejected += keep ? 0 : 1;
+    return keep;
+}
+
+void RefractoryFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                      std::vector<Metavision::EventCD> &out) {
+    const size_t count = static_cast<size_t>(end - begin);
+    out.resize(count);
+    if (count == 0) {
+        return;
+    }
+    // 整个批次落在同一时间范围内时省去逐事件的基准检查
+    if (!mHasBase || (end - 1)->t - mBase >= kTimeLimit) {
+        rebase(begin->t);
+    }
+    size_t kept = 0;
+    if ((end - 1)->t - mBase < kTimeLimit && begin->t >= mBase) {
+        kept = mRefillQ32 != 0 ? admitRange<true>(begin, end, out.data(), mState.data(), mWidth, mBase, mDeadTicks,
+                                                  mRefillQ32, mCapacity)
+                               : admitRange<false>(begin, end, out.data(), mState.data(), mWidth, mBase, mDeadTicks,
+                                                   mRefillQ32, mCapacity);
+        mProcessed += count;
+        mRejected += count - kept;
+    } else {
+        for (const Metavision::EventCD *event = begin; event != end; ++event) {
+            out[kept] = *event;
+            kept += evaluate(*event) ? 1 : 0;
+        }
+    }
+    out.resize(kept);
+}
+
+std::vector<Metavision::EventCD> RefractoryFilter::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> retained_events;
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+void RefractoryFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('R', 'F', 'R', 'C'));
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.writeValue<int32_t>(mBurstSize);
+    writer.write(mState);
+    writer.writeValue<int64_t>(mBase);
+    writer.writeValue<uint8_t>(mHasBase);
+    writer.writeValue<uint64_t>(mProcessed);
+    writer.writeValue<uint64_t>(mRejected);
+    writer.close();
+}
+
+void RefractoryFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('R', 'F', 'R', 'C'));
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    reader.expectValue<int32_t>(mBurstSize, "burstSize");
+    std::vector<uint32_t> state;
+    reader.read(state);
+    if (state.size() != mState.size()) {
+        throw std::invalid_argument("RefractoryFilter: state size does not match filter geometry: " + path);
+    }
+    const int64_t base = reader.readValue<int64_t>();
+    const bool hasBase = reader.readValue<uint8_t>() != 0;
+    const uint64_t processed = reader.readValue<uint64_t>();
+    const uint64_t rejected = reader.readValue<uint64_t>();
+    // 所有段都读取成功后再提交，失败时保持原状态
+    mState.swap(state);
+    mBase = base;
+    mHasBase = hasBase;
+    mProcessed = processed;
+    mRejected = rejected;
+}
+
+} // namespace Denoise
+} // namespace Algorithm
+} // namespace Shimeta
@@ -14,19 +14,24 @@
  * limitations under the License.
  */
 #include "denoise/timesurface_denoisor.h"
+#include "utils/state_snapshot.h"
+
+#include <algorithm>
 
 namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
 
-TimeSurfaceDenoisor::TimeSurfaceDenoisor(int width, int height, double decay, size_t searchRadius, double floatThreshold)
-    : mWidth(width), mHeight(height), mSearchRadius(searchRadius), mDecay(decay), mFloatThreshold(floatThreshold) {
+TimeSurfaceDenoisor::TimeSurfaceDenoisor(int width, int height, double decay, size_t searchRadius, double floatThreshold,
+                                         Utils::SurfaceLayout layout)
+    : mWidth(width), mHeight(height), mSearchRadius(searchRadius), mDecay(decay), mFloatThreshold(floatThreshold),
+      mPos(width, height, layout), mNeg(width, height, layout) {
     initialize();
 }
 
 void TimeSurfaceDenoisor::initialize() {
-    mPos.assign(mWidth, std::vector<int64_t>(mHeight, 0));
-    mNeg.assign(mWidth, std::vector<int64_t>(mHeight, 0));
+    mPos.fill(0);
+    mNeg.fill(0);
 }
 
 bool TimeSurfaceDenoisor::evaluate(const Metavision::EventCD &event) {
@@ -38,14 +43,17 @@ bool TimeSurfaceDenoisor::evaluate(const Metavision::EventCD &event) {
     size_t support = 0;
     double diffTime = 0.0;
     auto &surface = (polarity == 1) ? mPos : mNeg;
+    const int64_t *times = surface.data();
+    const uint32_t *columns = surface.index().columnOffsets();
+    const uint32_t *rows = surface.index().rowOffsets();
 
-    for (int dx = -static_cast<int>(mSearchRadius); dx <= static_cast<int>(mSearchRadius); ++dx) {
-        for (int dy = -static_cast<int>(mSearchRadius); dy <= static_cast<int>(mSearchRadius); ++dy) {
-            int nx = x + dx;
-            int ny = y + dy;
-            if (nx < 0 || ny < 0 || nx >= mWidth || ny >= mHeight)
-                continue;
-            int64_t neighbor_ts = surface[nx][ny];
+    const int radius = static_cast<int>(mSearchRadius);
+    const int y0 = std::max(0, y - radius);
+    const int y1 = std::min(mHeight - 1, y + radius);
+    for (int nx = std::max(0, x - radius); nx <= std::min(mWidth - 1, x + radius); ++nx) {
+        const int64_t *column = times + columns[nx];
+        for (int ny = y0; ny <= y1; ++ny) {
+            int64_t neighbor_ts = column[rows[ny]];
             if (neighbor_ts == 0)
                 continue;
             diffTime += std::exp((neighbor_ts - ts) / mDecay);
@@ -54,19 +62,51 @@ bool TimeSurfaceDenoisor::evaluate(const Metavision::EventCD &event) {
     }
     double surface_val = (support == 0) ? 0.0 : diffTime / support;
     // 更新时间表面
-    surface[x][y] = ts;
+    surface(x, y) = ts;
     return surface_val >= mFloatThreshold;
 }
 
+void TimeSurfaceDenoisor::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                         std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> TimeSurfaceDenoisor::process_events(const std::vector<Metavision::EventCD> &events) {
-    std::vector<Metavision::EventCD> output;
-    output.reserve(events.size());
-    for (const auto &event : events) {
-        if (retain(event)) {
-            output.push_back(event);
-        }
+    std::vector<Metavision::EventCD> retained_events;
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+void TimeSurfaceDenoisor::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('T', 'S', 'D', 'S'));
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.write(mPos.columns());
+    writer.write(mNeg.columns());
+    writer.close();
+}
+
+void TimeSurfaceDenoisor::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('T', 'S', 'D', 'S'));
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    std::vector<int64_t> onColumns;
+    std::vector<int64_t> offColumns;
+    reader.read(onColumns);
+    reader.read(offColumns);
+    // 快照按列主序保存 width*height 个像素，与表面布局（及其填充）无关
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    if (onColumns.size() != pixels || offColumns.size() != pixels) {
+        throw std::invalid_argument("TimeSurfaceDenoisor: state size does not match filter geometry: " + path);
     }
-    return output;
+    mPos.assignColumns(onColumns);
+    mNeg.assignColumns(offColumns);
 }
 
 } // namespace Denoise
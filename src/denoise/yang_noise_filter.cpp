@@ -14,48 +14,138 @@
  * limitations under the License.
  */
 #include "denoise/yang_noise_filter.h"
+#include "utils/state_snapshot.h"
+
+#include <algorithm>
 
 namespace Shimeta {
 namespace Algorithm {
 namespace Denoise {
 
+namespace {
+
+// version 2 adds the duration to the header
+constexpr uint32_t kStateVersion = 2;
+
+} // namespace
+
 YangNoiseFilter::YangNoiseFilter(
     const int16_t width,
     const int16_t height,
     const int64_t duration,
     const size_t searchRadius,
-    const size_t intThreshold
+    const size_t intThreshold,
+    const bool useSlidingWindow,
+    const Utils::SurfaceLayout layout
 ) :
     mWidth(width),
     mHeight(height),
     mDuration(duration),
     mSearchRadius(searchRadius),
-    mIntThreshold(intThreshold)
+    mIntThreshold(intThreshold),
+    mUseSlidingWindow(useSlidingWindow),
+    mLastTimestamps(width, height, layout),
+    mLastPolarities(width, height, layout),
+    mSeedPending(false)
 {
     initialize();
 }
 
 void YangNoiseFilter::initialize() {
-    mLastTimestamps.assign(mWidth, std::vector<int64_t>(mHeight, 0));
-    mLastPolarities.assign(mWidth, std::vector<uint8_t>(mHeight, 0));
+    mLastTimestamps.fill(0);
+    mLastPolarities.fill(0);
+
+    mColumnCounts.clear();
+    mActive.clear();
+    mWindowEvents.clear();
+    mSeedPending = false;
+    if (!mUseSlidingWindow) {
+        return;
+    }
+
+    // Every pixel starts with timestamp 0 and polarity 0, which the brute-force scan counts as an
+    // active negative event until the first timestamp beyond duration, so seed the counts the same way.
+    const int radius = static_cast<int>(mSearchRadius);
+    mColumnCounts.assign(2 * static_cast<size_t>(mWidth) * mHeight, 0);
+    mActive.assign(static_cast<size_t>(mWidth) * mHeight, 1);
+    for (int y = 0; y < mHeight; ++y) {
+        const int rows = std::min<int>(mHeight - 1, y + radius) - std::max(0, y - radius) + 1;
+        std::fill_n(mColumnCounts.begin() + static_cast<size_t>(y) * mWidth, mWidth, static_cast<uint16_t>(rows));
+    }
+    mSeedPending = true;
+}
+
+void YangNoiseFilter::updateColumnCounts(int16_t x, int16_t y, uint8_t polarity, int delta) {
+    const int radius = static_cast<int>(mSearchRadius);
+    const int yBegin = std::max(0, y - radius);
+    const int yEnd = std::min<int>(mHeight - 1, y + radius);
+    uint16_t *column = mColumnCounts.data() + (static_cast<size_t>(polarity) * mHeight + yBegin) * mWidth + x;
+    for (int row = yBegin; row <= yEnd; ++row, column += mWidth) {
+        *column = static_cast<uint16_t>(*column + delta);
+    }
+}
+
+void YangNoiseFilter::expire(int64_t now) {
+    const int64_t horizon = now - mDuration;
+
+    if (mSeedPending && horizon > 0) {
+        for (int16_t x = 0; x < mWidth; ++x) {
+            for (int16_t y = 0; y < mHeight; ++y) {
+                uint8_t &active = mActive[static_cast<size_t>(y) * mWidth + x];
+                if (active && mLastTimestamps(x, y) == 0) {
+                    updateColumnCounts(x, y, mLastPolarities(x, y), -1);
+                    active = 0;
+                }
+            }
+        }
+        mSeedPending = false;
+    }
+
+    while (!mWindowEvents.empty() && mWindowEvents.front().t < horizon) {
+        const auto &old = mWindowEvents.front();
+        uint8_t &active = mActive[static_cast<size_t>(old.y) * mWidth + old.x];
+        // Skip pixels that were refreshed since this entry was queued, or already expired
+        if (active && mLastTimestamps(old.x, old.y) == old.t) {
+            updateColumnCounts(old.x, old.y, mLastPolarities(old.x, old.y), -1);
+            active = 0;
+        }
+        mWindowEvents.pop_front();
+    }
 }
 
 size_t YangNoiseFilter::calculateDensity(const Metavision::EventCD &event) {
     size_t density = 0;
+    // polarity doubles as the plane index, so any positive value is ON and anything else OFF
+    const uint8_t polarity = event.p > 0 ? 1 : 0;
+
+    if (mUseSlidingWindow) {
+        expire(event.t);
+
+        const int radius = static_cast<int>(mSearchRadius);
+        const int xBegin = std::max(0, event.x - radius);
+        const int xEnd = std::min<int>(mWidth - 1, event.x + radius);
+        const uint16_t *row = mColumnCounts.data() + (static_cast<size_t>(polarity) * mHeight + event.y) * mWidth;
+        for (int x = xBegin; x <= xEnd; ++x) {
+            density += row[x];
+        }
+        return density;
+    }
 
     // Calculate spatio-temporal density
-    for (int16_t dy = -mSearchRadius; dy <= (int16_t)mSearchRadius; ++dy) {
-        for (int16_t dx = -mSearchRadius; dx <= (int16_t)mSearchRadius; ++dx) {
-            int16_t x = event.x + dx;
-            int16_t y = event.y + dy;
-
-            if (x >= 0 && x < mWidth && y >= 0 && y < mHeight) {
-                if (event.t - mLastTimestamps[x][y] <= mDuration) {
-                    if (event.p == mLastPolarities[x][y]) {
-                        density++;
-                    }
-                }
-            }
+    const int64_t *timestamps = mLastTimestamps.data();
+    const uint8_t *polarities = mLastPolarities.data();
+    const uint32_t *columns = mLastTimestamps.index().columnOffsets();
+    const uint32_t *rows = mLastTimestamps.index().rowOffsets();
+    const int radius = static_cast<int>(mSearchRadius);
+    const int yBegin = std::max(0, event.y - radius);
+    const int yEnd = std::min<int>(mHeight - 1, event.y + radius);
+    const int xEnd = std::min<int>(mWidth - 1, event.x + radius);
+    const int64_t horizon = event.t - mDuration;
+    for (int x = std::max(0, event.x - radius); x <= xEnd; ++x) {
+        for (int y = yBegin; y <= yEnd; ++y) {
+            // both tests are data dependent, count without branching
+            const size_t pixel = static_cast<size_t>(columns[x]) + rows[y];
+            density += static_cast<size_t>((timestamps[pixel] >= horizon) & (polarities[pixel] == polarity));
         }
     }
 
@@ -68,22 +158,101 @@ bool YangNoiseFilter::evaluate(const Metavision::EventCD &event) {
 
     // evaluate
     bool isSignal = (density >= mIntThreshold);
+    const uint8_t polarity = event.p > 0 ? 1 : 0;
+
+    // update sliding-window counts, replacing the pixel's previous contribution if still active
+    if (mUseSlidingWindow) {
+        uint8_t &active = mActive[static_cast<size_t>(event.y) * mWidth + event.x];
+        if (active) {
+            updateColumnCounts(event.x, event.y, mLastPolarities(event.x, event.y), -1);
+        }
+        updateColumnCounts(event.x, event.y, polarity, +1);
+        active = 1;
+        mWindowEvents.push_back(event);
+    }
 
     // update matrix
-    mLastTimestamps[event.x][event.y] = event.t;
-    mLastPolarities[event.x][event.y] = event.p;
+    mLastTimestamps(event.x, event.y) = event.t;
+    mLastPolarities(event.x, event.y) = polarity;
 
     return isSignal;
 }
 
+void YangNoiseFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                     std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[kept] = *event;
+        kept += retain(*event) ? 1 : 0;
+    }
+    out.resize(kept);
+}
+
 std::vector<Metavision::EventCD> YangNoiseFilter::process_events(const std::vector<Metavision::EventCD> &events) {
     std::vector<Metavision::EventCD> retained_events;
-    for (const auto& event : events) {
-        if (retain(event)) {
-            retained_events.push_back(event);
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+void YangNoiseFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('Y', 'N', 'F', 'S'), kStateVersion);
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.writeValue<int64_t>(mDuration);
+    writer.writeValue<uint8_t>(mUseSlidingWindow);
+    writer.write(mLastTimestamps.columns());
+    writer.write(mLastPolarities.columns());
+    if (mUseSlidingWindow) {
+        writer.writeValue<uint64_t>(mSearchRadius);
+        writer.writeValue<uint8_t>(mSeedPending);
+        writer.write(mColumnCounts);
+        writer.write(mActive);
+        writer.write(mWindowEvents);
+    }
+    writer.close();
+}
+
+void YangNoiseFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('Y', 'N', 'F', 'S'), kStateVersion);
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    // the window contents and the "recent" test both depend on the duration
+    reader.expectValue<int64_t>(mDuration, "duration");
+    reader.expectValue<uint8_t>(mUseSlidingWindow, "counting mode");
+    std::vector<int64_t> timestamps;
+    reader.read(timestamps);
+    std::vector<uint8_t> polarities;
+    reader.read(polarities);
+    // sections hold width*height pixels in column-major order, whatever the surface layout and its padding
+    const size_t pixels = static_cast<size_t>(mWidth) * mHeight;
+    if (timestamps.size() != pixels || polarities.size() != pixels) {
+        throw std::invalid_argument("YangNoiseFilter: state size does not match filter geometry: " + path);
+    }
+    bool seedPending = mSeedPending;
+    std::vector<uint16_t> columnCounts;
+    std::vector<uint8_t> active;
+    std::deque<Metavision::EventCD> windowEvents;
+    if (mUseSlidingWindow) {
+        // the column counts depend on the search radius
+        reader.expectValue<uint64_t>(mSearchRadius, "search radius");
+        seedPending = reader.readValue<uint8_t>() != 0;
+        reader.read(columnCounts);
+        reader.read(active);
+        reader.read(windowEvents);
+        if (columnCounts.size() != mColumnCounts.size() || active.size() != mActive.size()) {
+            throw std::invalid_argument("YangNoiseFilter: state size does not match filter geometry: " + path);
         }
     }
-    return retained_events;
+    // commit only once every section has been read and validated, so a bad file leaves the filter untouched
+    mLastTimestamps.assignColumns(timestamps);
+    mLastPolarities.assignColumns(polarities);
+    if (mUseSlidingWindow) {
+        mSeedPending = seedPending;
+        mColumnCounts.swap(columnCounts);
+        mActive.swap(active);
+        mWindowEvents.swap(windowEvents);
+    }
 }
 
 } // namespace Denoise
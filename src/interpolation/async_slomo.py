@@ -4,6 +4,8 @@ script to upsample your videos
 from __future__ import absolute_import
 
 import os
+import queue
+import threading
 import urllib
 import torch
 import torch.nn as nn
@@ -60,6 +62,167 @@ def show_slowmo(last_frame, frame, flow_fw, flow_bw, interp, fps):
     return 1
 
 
+_END = object()
+
+
+def _read_frame(frame):
+    if isinstance(frame, str):
+        frame = cv2.imread(frame)[:, :, ::-1]
+        assert frame.shape[2] == 3
+    return frame
+
+
+def _decode_worker(stream, frames, stop):
+    """Decodes frames into a bounded queue (runs on its own thread)"""
+    try:
+        for i, frame in enumerate(stream):
+            if stop.is_set():
+                break
+            frames.put((i, _read_frame(frame)))
+    except Exception as e:
+        frames.put(e)
+    frames.put(_END)
+
+
+def _encode_worker(video_writer, chunks, errors):
+    """Writes chunks of frames from a bounded queue (runs on its own thread)
+    A failure is appended to errors and ends the thread, the main thread re-raises it.
+    """
+    try:
+        while True:
+            chunk = chunks.get()
+            if chunk is _END:
+                break
+            for item in chunk:
+                video_writer.writeFrame(item)
+    except Exception as e:
+        errors.append(e)
+
+
+def _put_chunk(chunks, chunk, encoder, errors):
+    """Queues a chunk for the encoder, raising its error instead of blocking once it has died"""
+    while True:
+        if errors:
+            raise errors[0]
+        if not encoder.is_alive():
+            raise RuntimeError("encoder thread stopped unexpectedly")
+        try:
+            chunks.put(chunk, timeout=0.1)
+            return
+        except queue.Full:
+            pass
+
+
+def interpolate_pipelined(slomo, stream, video_writer, sf, delta_t, viz, fps, batch_size=4, queue_size=16):
+    """Batched & pipelined interpolation loop
+    Decoding and encoding run on background threads with bounded queues, while
+    the main thread interpolates batch_size consecutive frame pairs at once.
+    Output frames, timestamps and the "flow too small" skipping are identical to the
+    sequential loop: when a pair of the batch is skipped, the pairs after it are rebuilt
+    from the last kept frame and recomputed in the next batch.
+    Args:
+        slomo: SlowMoWarp
+        stream: iterable of frames or image paths
+        video_writer: FFmpegWriter or None
+        sf: desired frame-rate scale-factor (-1 for maximum optical flow)
+        delta_t: time between two input frames
+        viz: visualize the flow and interpolated frames
+        fps: input frame-rate
+        batch_size: number of frame pairs per forward pass
+        queue_size: capacity of the decode and encode queues
+    Returns:
+        list of timestamp arrays
+    """
+    frames = queue.Queue(maxsize=queue_size)
+    chunks = queue.Queue(maxsize=queue_size)
+    errors = []
+    stop = threading.Event()
+    decoder = threading.Thread(target=_decode_worker, args=(stream, frames, stop), daemon=True)
+    decoder.start()
+    encoder = None
+    if video_writer is not None:
+        encoder = threading.Thread(target=_encode_worker, args=(video_writer, chunks, errors), daemon=True)
+        encoder.start()
+
+    def next_frame():
+        item = frames.get()
+        if isinstance(item, Exception):
+            raise item
+        return item
+
+    timestamps = []
+    pending = []
+    last = None
+    last_ts = 0
+    done = False
+    progress = tqdm(total=len(stream))
+    try:
+        while True:
+            while not done and len(pending) < batch_size:
+                item = next_frame()
+                if item is _END:
+                    done = True
+                    break
+                progress.update(1)
+                if last is None:
+                    last = item[1]
+                    continue
+                pending.append(item)
+            if not pending:
+                break
+
+            firsts = [last] + [frame for _, frame in pending[:-1]]
+            with torch.no_grad():
+                outs = slomo.forward_batch(firsts, [frame for _, frame in pending], sf=sf)
+
+            consumed = 0
+            quit_viz = False
+            for (i, frame), out in zip(pending, outs):
+                consumed += 1
+                ts = i * delta_t
+                if out["sf"] == 0:
+                    # the next pairs were built on this frame, recompute them from last
+                    print("skipping here, flow too small")
+                    break
+
+                interp = [last] + out["interpolated"]
+                dt = (ts - last_ts) / len(interp)
+                timestamps.append(np.linspace(last_ts, ts - dt, len(interp)))
+                if encoder is not None:
+                    _put_chunk(chunks, interp, encoder, errors)
+
+                if viz and show_slowmo(last, frame, *out['flow'], interp, fps) == 0:
+                    quit_viz = True
+                    break
+
+                last_ts = ts
+                last = frame
+            pending = pending[consumed:]
+            if quit_viz:
+                break
+    finally:
+        progress.close()
+        stop.set()
+        # unblock the decoder if it waits on a full queue
+        while decoder.is_alive():
+            try:
+                frames.get(timeout=0.1)
+            except queue.Empty:
+                pass
+        if encoder is not None:
+            # a dead encoder no longer drains the queue, so only wait for one that is still running
+            while encoder.is_alive():
+                try:
+                    chunks.put(_END, timeout=0.1)
+                    break
+                except queue.Full:
+                    pass
+            encoder.join()
+    if errors:
+        raise errors[0]
+    return timestamps
+
+
 def main_video(
         video_filename,
         out_name="",
@@ -73,7 +236,11 @@ def main_video(
         cuda=True,
         viz=False,
         checkpoint='SuperSloMo.ckpt',
-        crf=1
+        crf=1,
+        batch_size=1,
+        queue_size=16,
+        probe_scale=1.0,
+        tile_size=0
 ):
     """SlowMo Interpolates video
     It produces another .mp4 video + .npy file for timestamps.
@@ -91,6 +258,12 @@ def main_video(
         cuda: use cuda
         viz: visualize the flow and interpolated frames
         checkpoint: if not provided will download it
+        batch_size: if > 1, interpolates this many frame pairs per forward pass with
+        decoding and encoding on background threads
+        queue_size: capacity of the decode/encode queues in batched mode
+        probe_scale: if < 1 (and sf=-1), decides sf or skips the pair from a flow pass on
+        frames downsampled by this factor before running the full model
+        tile_size: if > 0, runs the networks on tiles of this size to bound memory on CPU
     """
 
     print("Out Video: ", out_name)
@@ -113,7 +286,8 @@ def main_video(
             rgb=True)
         height, width = stream.height, stream.width
 
-    slomo = SlowMoWarp(height, width, checkpoint, lambda_flow=lambda_flow, cuda=cuda)
+    slomo = SlowMoWarp(height, width, checkpoint, lambda_flow=lambda_flow, cuda=cuda,
+                       probe_scale=probe_scale, tile_size=tile_size)
 
     fps = video_fps
 
@@ -138,44 +312,48 @@ def main_video(
             # other options see https://trac.ffmpeg.org/wiki/Encode/H.264
         })
 
-    last_ts = 0
-    for i, frame in enumerate(tqdm(stream)):
-        if isinstance(frame, str):
-            frame = cv2.imread(frame)[:, :, ::-1]
-            assert frame.shape[2] == 3
+    if batch_size > 1:
+        timestamps = interpolate_pipelined(slomo, stream, video_writer if out_name else None, sf, delta_t,
+                                           viz, fps, batch_size, queue_size)
+    else:
+        last_ts = 0
+        for i, frame in enumerate(tqdm(stream)):
+            if isinstance(frame, str):
+                frame = cv2.imread(frame)[:, :, ::-1]
+                assert frame.shape[2] == 3
 
-        ts = i * delta_t
+            ts = i * delta_t
 
-        if last_frame is not None:
+            if last_frame is not None:
 
-            t_start = last_ts
-            t_end = ts
+                t_start = last_ts
+                t_end = ts
 
-            with torch.no_grad():
-                out = slomo.forward(last_frame, frame, sf=sf)
+                with torch.no_grad():
+                    out = slomo.forward(last_frame, frame, sf=sf)
 
-            interp = [last_frame] + out["interpolated"]
-            dt = (t_end - t_start) / len(interp)
-            interp_ts = np.linspace(t_start, t_end - dt, len(interp))
+                interp = [last_frame] + out["interpolated"]
+                dt = (t_end - t_start) / len(interp)
+                interp_ts = np.linspace(t_start, t_end - dt, len(interp))
 
-            if out["sf"] == 0:
-                print("skipping here, flow too small")
-                continue
+                if out["sf"] == 0:
+                    print("skipping here, flow too small")
+                    continue
 
-            if out_name:
-                for item in interp:
-                    video_writer.writeFrame(item)
+                if out_name:
+                    for item in interp:
+                        video_writer.writeFrame(item)
 
-            timestamps.append(interp_ts)
+                timestamps.append(interp_ts)
 
-            if viz:
-                key = show_slowmo(last_frame, frame, *out['flow'], interp, fps)
-                if key == 0:
-                    break
+                if viz:
+                    key = show_slowmo(last_frame, frame, *out['flow'], interp, fps)
+                    if key == 0:
+                        break
 
-            last_ts = ts
+                last_ts = ts
 
-        last_frame = frame.copy()
+            last_frame = frame.copy()
 
     if viz:
         cv2.destroyWindow("result")
@@ -200,10 +378,15 @@ def main(
         viz=False,
         checkpoint='../../models/SuperSloMo.ckpt',
         crf=1,
-        rewrite=True):
+        rewrite=True,
+        batch_size=1,
+        queue_size=16,
+        probe_scale=1.0,
+        tile_size=0):
     """Same Documentation, just with additional input directory"""
     def main_fun(x, y): return main_video(x, y, video_fps, height, width, sf,
-                                          seek_frame, max_frames, lambda_flow, cuda, viz, checkpoint, crf)
+                                          seek_frame, max_frames, lambda_flow, cuda, viz, checkpoint, crf,
+                                          batch_size, queue_size, probe_scale, tile_size)
     wsf = str(sf) if sf > 0 else "asynchronous"
     print('Interpolation frame_rate factor: ', wsf)
     if os.path.isdir(input_path):
@@ -23,8 +23,14 @@ class SlowMoWarp:
         checkpoint: network checkpoint
         lambda flow: modules max flow to produce N images
         cuda: use cuda
+        probe_scale: if < 1, with sf=-1 the maximum flow is first estimated on the pair
+        downsampled by this factor; sf is decided (or the pair skipped) before running
+        the full resolution model
+        tile_size: if > 0, the UNets run on overlapping tiles of this size to bound memory
+        tile_overlap: margin discarded on each inner tile border
     """
-    def __init__(self, height, width, checkpoint, lambda_flow=0.5, cuda=True):
+    def __init__(self, height, width, checkpoint, lambda_flow=0.5, cuda=True,
+                 probe_scale=1.0, tile_size=0, tile_overlap=32):
 
         self.device = torch.device(
             "cuda:0" if torch.cuda.is_available() and cuda else "cpu"
@@ -60,6 +66,72 @@ class SlowMoWarp:
             [self.revNormalize, move_back_channel, to_numpy]
         )
         self.lambda_flow = lambda_flow
+        self.probe_scale = probe_scale
+        self.tile_size = tile_size
+        self.tile_overlap = tile_overlap
+
+    @staticmethod
+    def tile_ranges(size, tile, overlap):
+        """Yields (start, valid_begin, valid_end) of the tiles along one axis"""
+        if tile <= 0 or size <= tile:
+            yield 0, 0, size
+            return
+        overlap = min(overlap, (tile - 1) // 2)
+        step = tile - 2 * overlap
+        start = 0
+        while True:
+            last = start + tile >= size
+            start = min(start, size - tile)
+            begin = 0 if start == 0 else start + overlap
+            end = size if last else start + tile - overlap
+            yield start, begin, end
+            if last:
+                break
+            start += step
+
+    def run_net(self, net, x):
+        """Runs a UNet, tile by tile if tile_size is set
+
+        The network is fully convolutional; tiles overlap by tile_overlap so the
+        discarded borders hide the missing context.
+        """
+        height, width = x.shape[-2:]
+        if self.tile_size <= 0 or (height <= self.tile_size and width <= self.tile_size):
+            return net(x)
+        out = None
+        for y0, ya, yb in self.tile_ranges(height, self.tile_size, self.tile_overlap):
+            for x0, xa, xb in self.tile_ranges(width, self.tile_size, self.tile_overlap):
+                tile = net(x[..., y0:y0 + self.tile_size, x0:x0 + self.tile_size])
+                if out is None:
+                    out = tile.new_empty(tile.shape[:2] + (height, width))
+                out[..., ya:yb, xa:xb] = tile[..., ya - y0:yb - y0, xa - x0:xb - x0]
+        return out
+
+    def compute_flow(self, I0, I1):
+        flowOut = self.run_net(self.flowComp, torch.cat((I0, I1), dim=1))
+        return flowOut[:, :2, :, :], flowOut[:, 2:, :, :]
+
+    def max_flow_sf(self, F_0_1, F_1_0):
+        """Scale factor of every pair of a batch from its maximum optical flow"""
+        fwd_mag_max = F_0_1.norm(dim=1).flatten(1).max(dim=1)[0]
+        bwd_mag_max = F_1_0.norm(dim=1).flatten(1).max(dim=1)[0]
+        max_flow = torch.max(fwd_mag_max, bwd_mag_max).tolist()
+        return [int(round(item * self.lambda_flow)) for item in max_flow]
+
+    def probe_sf(self, I0, I1):
+        """Estimates the scale factor of every pair on a downsampled copy
+
+        The flow of the small pair is rescaled to full resolution pixels before
+        taking its maximum.
+        """
+        height, width = I0.shape[-2:]
+        size = (max(32, int(round(height * self.probe_scale))),
+                max(32, int(round(width * self.probe_scale))))
+        small0 = F.interpolate(I0, size=size, mode="area")
+        small1 = F.interpolate(I1, size=size, mode="area")
+        F_0_1, F_1_0 = self.compute_flow(small0, small1)
+        scale = torch.tensor([width / size[1], height / size[0]], device=F_0_1.device).view(1, 2, 1, 1)
+        return self.max_flow_sf(F_0_1 * scale, F_1_0 * scale)
 
     def interpolate_time(self, I0, I1, F_0_1, F_1_0, t):
         temp = -t * (1 - t)
@@ -71,7 +143,8 @@ class SlowMoWarp:
         g_I0_F_t_0 = self.flowBackWarp(I0, F_t_0)
         g_I1_F_t_1 = self.flowBackWarp(I1, F_t_1)
 
-        intrpOut = self.ArbTimeFlowIntrp(
+        intrpOut = self.run_net(
+            self.ArbTimeFlowIntrp,
             torch.cat(
                 (I0, I1, F_0_1, F_1_0, F_t_1, F_t_0, g_I1_F_t_1, g_I0_F_t_0), dim=1
             )
@@ -114,14 +187,78 @@ class SlowMoWarp:
         sf = int(round(max(fwd_mag_max, bwd_mag_max) * self.lambda_flow))
         return self.interpolate_sync(I0, I1, F_0_1, F_1_0, sf), sf
 
+    def interpolate_batch(self, I0, I1, F_0_1, F_1_0, sf=2):
+        """Interpolates sf-1 frames for every pair of a batch
+
+        Returns:
+            one list of interpolated frames per pair
+        """
+        interpolated = [[] for _ in range(I0.shape[0])]
+        for intermediateIndex in range(1, sf):
+            t = float(intermediateIndex) / sf
+            Ft_p = self.interpolate_time(I0, I1, F_0_1, F_1_0, t)
+            for b in range(Ft_p.shape[0]):
+                interpolated[b].append(self.rev_transform(Ft_p[b]))
+        return interpolated
+
+    def forward_batch(self, frames0, frames1, sf=-1):
+        """Interpolates several frame pairs at once
+
+        Flow is computed for the whole batch in one pass; interpolation runs
+        once per distinct scale factor on the pairs that share it.
+
+        Args:
+            frames0: list of first rgb frames (h,w,3)
+            frames1: list of second rgb frames (h,w,3)
+            sf: scale factor (if -1 it is decided per pair from maximum optical flow)
+
+        Returns:
+            list with one dict per pair, same content as forward()
+        """
+        I0 = torch.stack([self.transform(frame) for frame in frames0]).to(self.device)
+        I1 = torch.stack([self.transform(frame) for frame in frames1]).to(self.device)
+
+        outputs = [{"flow": None, "interpolated": [], "sf": sf} for _ in frames0]
+        active = list(range(len(frames0)))
+        if sf == -1 and self.probe_scale < 1:
+            sfs = self.probe_sf(I0, I1)
+            for output, value in zip(outputs, sfs):
+                output["sf"] = value
+            active = [b for b in active if sfs[b] != 0]
+            if not active:
+                return outputs
+            if len(active) < len(frames0):
+                sel = torch.tensor(active, device=self.device)
+                I0, I1 = I0[sel], I1[sel]
+
+        F_0_1, F_1_0 = self.compute_flow(I0, I1)
+        if sf == -1 and self.probe_scale >= 1:
+            for output, value in zip(outputs, self.max_flow_sf(F_0_1, F_1_0)):
+                output["sf"] = value
+        for k, b in enumerate(active):
+            outputs[b]["flow"] = (F_0_1[k:k + 1], F_1_0[k:k + 1])
+
+        sfs = [outputs[b]["sf"] for b in active]
+        for value in sorted(set(sfs)):
+            if value < 2:
+                continue
+            index = [k for k, item in enumerate(sfs) if item == value]
+            sel = torch.tensor(index, device=self.device)
+            interpolated = self.interpolate_batch(I0[sel], I1[sel], F_0_1[sel], F_1_0[sel], value)
+            for k, frames in zip(index, interpolated):
+                outputs[active[k]]["interpolated"] = frames
+        return outputs
+
     def forward(self, frame0, frame1, sf=-1):
         I0 = self.transform(frame0).to(self.device)[None]
         I1 = self.transform(frame1).to(self.device)[None]
 
-        P01 = torch.cat((I0, I1), dim=1)
-        flowOut = self.flowComp(P01)
-        F_0_1 = flowOut[:, :2, :, :]
-        F_1_0 = flowOut[:, 2:, :, :]
+        if sf == -1 and self.probe_scale < 1:
+            sf = self.probe_sf(I0, I1)[0]
+            if sf == 0:
+                return {"flow": None, "interpolated": [], "sf": sf}
+
+        F_0_1, F_1_0 = self.compute_flow(I0, I1)
 
         if sf == -1:
             inter_frame, sf = self.interpolate_max_flow(I0, I1, F_0_1, F_1_0)
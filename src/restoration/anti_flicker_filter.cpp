@@ -0,0 +1,161 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "restoration/anti_flicker_filter.h"
+#include "utils/state_snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Restoration {
+
+namespace {
+constexpr uint8_t kPositive = 1;
+constexpr uint8_t kHasOnset = 2;
+} // namespace
+
+AntiFlickerFilter::AntiFlickerFilter(
+    int width,
+    int height,
+    double minFrequency,
+    double maxFrequency,
+    int64_t periodTolerance,
+    int minCycles,
+    int blockSize
+) :
+    mWidth(width),
+    mHeight(height),
+    mBlockSize(blockSize),
+    mMinFrequency(minFrequency),
+    mMaxFrequency(maxFrequency),
+    mPeriodTolerance(periodTolerance),
+    mMinCycles(static_cast<uint8_t>(std::min(std::max(minCycles, 1), 255)))
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("AntiFlickerFilter: width and height must be positive");
+    }
+    if (blockSize <= 0) {
+        throw std::invalid_argument("AntiFlickerFilter: blockSize must be positive");
+    }
+    // 周期以 16 位饱和保存，频段下限不能低于 16 Hz
+    if (minFrequency < 16.0 || maxFrequency <= minFrequency) {
+        throw std::invalid_argument("AntiFlickerFilter: frequency band must satisfy 16 <= min < max");
+    }
+    mMinPeriod = static_cast<uint32_t>(std::floor(1e6 / maxFrequency));
+    mMaxPeriod = static_cast<uint32_t>(std::ceil(1e6 / minFrequency));
+    mGridWidth = (width + blockSize - 1) / blockSize;
+    initialize();
+}
+
+void AntiFlickerFilter::initialize() {
+    const int gridHeight = (mHeight + mBlockSize - 1) / mBlockSize;
+    mCells.assign(static_cast<size_t>(mGridWidth) * gridHeight, Cell{0, 0, 0, 0});
+    mProcessed = 0;
+    mRejected = 0;
+}
+
+bool AntiFlickerFilter::evaluate(const Metavision::EventCD &event) {
+    Cell &cell = mCells[static_cast<size_t>(event.y / mBlockSize) * mGridWidth + event.x / mBlockSize];
+    const uint32_t t = static_cast<uint32_t>(event.t);
+    const uint8_t positive = event.p > 0 ? kPositive : 0;
+
+    if (positive && !(cell.flags & kPositive)) {
+        // 负到正的翻转，与上一次翻转的间隔即闪烁周期
+        const uint32_t period = t - cell.onset;
+        if (!(cell.flags & kHasOnset) || period > mMaxPeriod) {
+            cell.onset = t;
+            cell.period = 0;
+            cell.cycles = 0;
+            cell.flags |= kHasOnset;
+        } else if (period >= mMinPeriod) {
+            const int64_t change = static_cast<int64_t>(period) - static_cast<int64_t>(cell.period);
+            if (std::abs(change) <= mPeriodTolerance) {
+                cell.cycles = static_cast<uint8_t>(std::min(cell.cycles + 1, 255));
+            } else if (cell.cycles > 0) {
+                --cell.cycles;
+            }
+            cell.onset = t;
+            cell.period = static_cast<uint16_t>(period);
+        }
+        // 短于最短周期的翻转视为突发内的噪声，不更新 onset
+    }
+    cell.flags = static_cast<uint8_t>((cell.flags & ~kPositive) | positive);
+
+    const bool flicker = cell.cycles >= mMinCycles && t - cell.onset <= 2 * mMaxPeriod;
+    ++mProcessed;
+    mRejected += flicker ? 1 : 0;
+    return !flicker;
+}
+
+void AntiFlickerFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                       std::vector<Metavision::EventCD> &out) {
+    out.resize(static_cast<size_t>(end - begin));
+    size_t count = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        out[count] = *event;
+        count += retain(*event) ? 1 : 0;
+    }
+    out.resize(count);
+}
+
+std::vector<Metavision::EventCD> AntiFlickerFilter::process_events(const std::vector<Metavision::EventCD> &events) {
+    std::vector<Metavision::EventCD> retained_events;
+    process_events(events.data(), events.data() + events.size(), retained_events);
+    return retained_events;
+}
+
+bool AntiFlickerFilter::isFlickering(int x, int y, int64_t t) const noexcept {
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) {
+        return false;
+    }
+    const Cell &cell = mCells[static_cast<size_t>(y / mBlockSize) * mGridWidth + x / mBlockSize];
+    return cell.cycles >= mMinCycles && static_cast<uint32_t>(t) - cell.onset <= 2 * mMaxPeriod;
+}
+
+void AntiFlickerFilter::save_state(const std::string &path) const {
+    Utils::StateWriter writer(path, Utils::stateTag('A', 'F', 'L', 'K'));
+    writer.writeValue<int32_t>(mWidth);
+    writer.writeValue<int32_t>(mHeight);
+    writer.writeValue<int32_t>(mBlockSize);
+    writer.write(mCells);
+    writer.writeValue<uint64_t>(mProcessed);
+    writer.writeValue<uint64_t>(mRejected);
+    writer.close();
+}
+
+void AntiFlickerFilter::load_state(const std::string &path) {
+    Utils::StateReader reader(path, Utils::stateTag('A', 'F', 'L', 'K'));
+    reader.expectValue<int32_t>(mWidth, "width");
+    reader.expectValue<int32_t>(mHeight, "height");
+    reader.expectValue<int32_t>(mBlockSize, "blockSize");
+    std::vector<Cell> cells;
+    reader.read(cells);
+    if (cells.size() != mCells.size()) {
+        throw std::invalid_argument("AntiFlickerFilter: state size does not match filter geometry: " + path);
+    }
+    const uint64_t processed = reader.readValue<uint64_t>();
+    const uint64_t rejected = reader.readValue<uint64_t>();
+    // 所有段都读取成功后再提交，失败时保持原状态
+    mCells.swap(cells);
+    mProcessed = processed;
+    mRejected = rejected;
+}
+
+} // namespace Restoration
+} // namespace Algorithm
+} // namespace Shimeta
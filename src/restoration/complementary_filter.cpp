@@ -0,0 +1,229 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "restoration/complementary_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Restoration {
+
+namespace {
+constexpr Metavision::timestamp kTimeLimit = Metavision::timestamp(1) << 30;
+
+size_t resolveThreads(size_t threads) {
+    return threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+}
+
+constexpr float kMaxCutoff = 1e5f;
+
+/// e^x，x <= 0，相对误差约 2e-6，小于 e^-87 时返回 0；截止频率上限与 32 位相对时间保证 x 转换为整数时不溢出；
+/// 只用乘加、截断与整数选择，不含浮点比较分支，循环中可被自动向量化
+inline float decayExp(float x) {
+    const float y = x * 1.44269504f;
+    int32_t n = static_cast<int32_t>(y);
+    n -= (static_cast<float>(n) > y) ? 1 : 0;
+    const float f = y - static_cast<float>(n);
+    // 2^f 在 [0, 1) 上的 7 阶泰勒展开
+    const float p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f + f * (0.00961812911f +
+                    f * (0.00133335581f + f * (0.000154035304f + f * 0.0000152527338f))))));
+    const int32_t bits = n < -126 ? 0 : (n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+/// 把 v 饱和到 [0, 255]，用绝对值代替比较，|v| 在 2^24 以内时精确
+inline float saturate255(float v) {
+    const float low = 0.5f * (v + std::fabs(v));
+    return 0.5f * (low + 255.0f - std::fabs(low - 255.0f));
+}
+} // namespace
+
+ComplementaryFilter::ComplementaryFilter(
+    int width,
+    int height,
+    float cutoffFrequency,
+    float contrastPositive,
+    float contrastNegative,
+    size_t threads
+) :
+    mWidth(width),
+    mHeight(height),
+    mPixels(static_cast<size_t>(std::max(width, 0)) * std::max(height, 0)),
+    mAlpha(cutoffFrequency),
+    mContrastPositive(contrastPositive),
+    mContrastNegative(contrastNegative),
+    // 行带数取线程数的 4 倍，与 EventRepresentation 相同
+    mPartitioner(std::max(height, 1), 4 * resolveThreads(threads)),
+    mHasBase(false),
+    mBase(0)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("ComplementaryFilter: width and height must be positive");
+    }
+    if (!(cutoffFrequency >= 0.0f && cutoffFrequency <= kMaxCutoff)) {
+        throw std::invalid_argument("ComplementaryFilter: cutoffFrequency must be in [0, 1e5]");
+    }
+    if (resolveThreads(threads) > 1) {
+        mPool = std::make_unique<Utils::WorkStealingPool>(resolveThreads(threads));
+    }
+    for (int i = 0; i < 256; ++i) {
+        mFrameLog[i] = std::log1p(static_cast<float>(i));
+    }
+    initialize();
+}
+
+void ComplementaryFilter::initialize() {
+    mLog.assign(mPixels, 0.0f);
+    mTarget.assign(mPixels, 0.0f);
+    mTime.assign(mPixels, 0);
+    mHasBase = false;
+    mBase = 0;
+}
+
+template <typename Body>
+void ComplementaryFilter::forEachRows(const Body &body) {
+    if (!mPool) {
+        body(0, mPixels);
+        return;
+    }
+    mPool->parallelFor(0, mPartitioner.bandCount(), [&](size_t first, size_t last) {
+        body(static_cast<size_t>(mPartitioner.bandBegin(first)) * mWidth,
+             static_cast<size_t>(mPartitioner.bandEnd(last - 1)) * mWidth);
+    }, 1);
+}
+
+void ComplementaryFilter::rebase(Metavision::timestamp t) {
+    if (!mHasBase) {
+        mBase = t;
+        mHasBase = true;
+        return;
+    }
+    if (t - mBase < kTimeLimit) {
+        return;
+    }
+    // 早于新基准 2^29 微秒以上的像素已完全衰减，截断其时间戳不影响结果
+    const Metavision::timestamp base = t - (kTimeLimit >> 1);
+    const Metavision::timestamp shift = base - mBase;
+    const Metavision::timestamp floor = -(kTimeLimit >> 1);
+    for (int32_t &time : mTime) {
+        time = static_cast<int32_t>(std::max(time - shift, floor));
+    }
+    mBase = base;
+}
+
+void ComplementaryFilter::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    if (begin == end) {
+        return;
+    }
+    rebase(begin->t);
+    rebase((end - 1)->t);
+    float *log = mLog.data();
+    const float *target = mTarget.data();
+    int32_t *time = mTime.data();
+    const size_t width = mWidth;
+    const Metavision::timestamp base = mBase;
+    const float rate = -mAlpha * 1e-6f;
+    const float positive = mContrastPositive;
+    const float negative = -mContrastNegative;
+    mPartitioner.forEach(begin, end, mPool.get(), [=](size_t, const Metavision::EventCD &event) {
+        const size_t i = static_cast<size_t>(event.y) * width + event.x;
+        const int32_t t = static_cast<int32_t>(event.t - base);
+        const float decay = decayExp(rate * static_cast<float>(std::max(t - time[i], 0)));
+        log[i] = target[i] + (log[i] - target[i]) * decay + (event.p > 0 ? positive : negative);
+        time[i] = t;
+    });
+}
+
+void ComplementaryFilter::process_events(const std::vector<Metavision::EventCD> &events) {
+    process_events(events.data(), events.data() + events.size());
+}
+
+void ComplementaryFilter::setFrame(const uint8_t *frame, Metavision::timestamp t) {
+    rebase(t);
+    const int32_t now = static_cast<int32_t>(t - mBase);
+    const float rate = -mAlpha * 1e-6f;
+    forEachRows([&](size_t first, size_t last) {
+        float *log = mLog.data();
+        float *target = mTarget.data();
+        int32_t *time = mTime.data();
+        // 写入的数组可能与捕获的参数别名，参数先复制到局部变量，避免每次迭代重新读取
+        const int32_t tNow = now;
+        const float tRate = rate;
+        for (size_t i = first; i < last; ++i) {
+            const float decay = decayExp(tRate * static_cast<float>(std::max(tNow - time[i], 0)));
+            log[i] = target[i] + (log[i] - target[i]) * decay;
+            time[i] = std::max(time[i], tNow);
+        }
+        // 查表是聚集访存，单独成环，不妨碍上面的循环向量化
+        for (size_t i = first; i < last; ++i) {
+            target[i] = mFrameLog[frame[i]];
+        }
+    });
+}
+
+void ComplementaryFilter::logFrame(Metavision::timestamp t, float *out) {
+    rebase(t);
+    const int32_t now = static_cast<int32_t>(t - mBase);
+    const float rate = -mAlpha * 1e-6f;
+    forEachRows([&](size_t first, size_t last) {
+        const float *log = mLog.data();
+        const float *target = mTarget.data();
+        const int32_t *time = mTime.data();
+        const int32_t tNow = now;
+        const float tRate = rate;
+        float *dst = out;
+        for (size_t i = first; i < last; ++i) {
+            const float decay = decayExp(tRate * static_cast<float>(std::max(tNow - time[i], 0)));
+            dst[i] = target[i] + (log[i] - target[i]) * decay;
+        }
+    });
+}
+
+void ComplementaryFilter::frame(Metavision::timestamp t, uint8_t *out, float logMin, float logMax) {
+    if (!(logMax > logMin)) {
+        throw std::invalid_argument("ComplementaryFilter: logMax must be greater than logMin");
+    }
+    rebase(t);
+    const int32_t now = static_cast<int32_t>(t - mBase);
+    const float rate = -mAlpha * 1e-6f;
+    const float scale = 255.0f / (logMax - logMin);
+    forEachRows([&](size_t first, size_t last) {
+        const float *log = mLog.data();
+        const float *target = mTarget.data();
+        const int32_t *time = mTime.data();
+        // 同 setFrame，uint8_t 输出还可能与任意对象别名
+        const int32_t tNow = now;
+        const float tRate = rate;
+        const float offset = logMin;
+        const float gain = scale;
+        uint8_t *dst = out;
+        for (size_t i = first; i < last; ++i) {
+            const float decay = decayExp(tRate * static_cast<float>(std::max(tNow - time[i], 0)));
+            const float value = (target[i] + (log[i] - target[i]) * decay - offset) * gain;
+            dst[i] = static_cast<uint8_t>(saturate255(value) + 0.5f);
+        }
+    });
+}
+
+} // namespace Restoration
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_buffer_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+EventBufferPool::Handle::Handle(EventBufferPool *pool, Buffer *buffer) noexcept :
+    mPool(pool),
+    mBuffer(buffer),
+    mCapacity(buffer->capacity())
+{
+}
+
+EventBufferPool::Handle::Handle(Handle &&other) noexcept :
+    mPool(std::exchange(other.mPool, nullptr)),
+    mBuffer(std::exchange(other.mBuffer, nullptr)),
+    mCapacity(other.mCapacity)
+{
+}
+
+EventBufferPool::Handle &EventBufferPool::Handle::operator=(Handle &&other) noexcept {
+    if (this != &other) {
+        release();
+        mPool = std::exchange(other.mPool, nullptr);
+        mBuffer = std::exchange(other.mBuffer, nullptr);
+        mCapacity = other.mCapacity;
+    }
+    return *this;
+}
+
+EventBufferPool::Handle::~Handle() {
+    release();
+}
+
+void EventBufferPool::Handle::release() {
+    if (mBuffer != nullptr) {
+        mPool->recycle(mBuffer, mCapacity);
+        mPool = nullptr;
+        mBuffer = nullptr;
+    }
+}
+
+EventBufferPool::EventBufferPool(size_t buffers, size_t capacity) :
+    mInUse(0),
+    mHighWaterMark(0),
+    mLargestCapacity(buffers > 0 ? capacity : 0),
+    mAcquisitions(0),
+    mAllocations(0)
+{
+    mBuffers.reserve(buffers);
+    mFree.reserve(buffers);
+    for (size_t i = 0; i < buffers; ++i) {
+        mBuffers.push_back(std::make_unique<Buffer>());
+        mBuffers.back()->reserve(capacity);
+        mFree.push_back(mBuffers.back().get());
+    }
+}
+
+EventBufferPool::Handle EventBufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFree.empty()) {
+        mBuffers.push_back(std::make_unique<Buffer>());
+        mFree.reserve(mBuffers.size());
+        mFree.push_back(mBuffers.back().get());
+        ++mAllocations;
+    }
+    // 最近归还的缓冲区最可能仍在缓存中
+    Buffer *buffer = mFree.back();
+    mFree.pop_back();
+    ++mAcquisitions;
+    mHighWaterMark = std::max(mHighWaterMark, ++mInUse);
+    return Handle(this, buffer);
+}
+
+EventBufferPool::Handle EventBufferPool::acquire(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    Handle handle = acquire();
+    handle->assign(begin, end);
+    return handle;
+}
+
+void EventBufferPool::recycle(Buffer *buffer, size_t capacity) {
+    const size_t grown = buffer->capacity();
+    buffer->clear();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (grown > capacity) {
+        ++mAllocations;
+    }
+    mLargestCapacity = std::max(mLargestCapacity, grown);
+    mFree.push_back(buffer);
+    --mInUse;
+}
+
+EventBufferPool::Stats EventBufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return Stats{mBuffers.size(), mInUse, mHighWaterMark, mLargestCapacity, mAcquisitions, mAllocations};
+}
+
+void EventBufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(), [this](const std::unique_ptr<Buffer> &buffer) {
+        return std::find(mFree.begin(), mFree.end(), buffer.get()) != mFree.end();
+    }), mBuffers.end());
+    mFree.clear();
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
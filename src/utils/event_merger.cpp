@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_merger.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+namespace {
+constexpr Metavision::timestamp kExhausted = std::numeric_limits<Metavision::timestamp>::max();
+constexpr Metavision::timestamp kSentinel = std::numeric_limits<Metavision::timestamp>::min();
+} // namespace
+
+EventMerger::EventMerger(size_t sources, size_t bufferSize, OutputCallback output) :
+    mBufferSize(bufferSize),
+    mOutput(std::move(output)),
+    mSources(sources)
+{
+    if (sources == 0 || sources >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("EventMerger: sources must be positive");
+    }
+    if (bufferSize == 0) {
+        throw std::invalid_argument("EventMerger: bufferSize must be positive");
+    }
+    mBuffer.resize(bufferSize);
+    reset();
+}
+
+void EventMerger::setOutputCallback(OutputCallback output) {
+    mOutput = std::move(output);
+}
+
+void EventMerger::setOffset(size_t source, int dx, int dy) {
+    mSources.at(source).offset = Offset{dx, dy};
+}
+
+void EventMerger::reset() {
+    for (Source &source : mSources) {
+        source.buffer.clear();
+        source.head = nullptr;
+        source.tail = nullptr;
+        source.watermark = kSentinel;
+        source.closed = false;
+    }
+    rebuild();
+}
+
+void EventMerger::rebuild() {
+    const size_t count = mSources.size();
+    mKeys.resize(count + 1);
+    for (size_t i = 0; i < count; ++i) {
+        const Source &source = mSources[i];
+        mKeys[i] = source.head != source.tail ? source.head->t : kExhausted;
+    }
+    // 哨兵先于所有源，逐个重赛后被挤出到根之外
+    mKeys[count] = kSentinel;
+    mTree.assign(count, static_cast<uint32_t>(count));
+    for (size_t i = count; i-- > 0;) {
+        replay(static_cast<uint32_t>(i));
+    }
+}
+
+void EventMerger::replay(uint32_t source) {
+    const size_t count = mSources.size();
+    uint32_t winner = source;
+    for (size_t node = (source + count) / 2; node > 0; node /= 2) {
+        if (before(mTree[node], winner)) {
+            std::swap(mTree[node], winner);
+        }
+    }
+    mTree[0] = winner;
+}
+
+size_t EventMerger::drain(Metavision::timestamp limit, Metavision::EventCD *dst, size_t capacity) {
+    const size_t count = mSources.size();
+    size_t written = 0;
+    while (written < capacity) {
+        const uint32_t winner = mTree[0];
+        if (mKeys[winner] == kExhausted || mKeys[winner] >= limit) {
+            break;
+        }
+        // 亚军一定是胜者路径上的某个败者；胜者领先亚军期间成段输出，只在段尾重赛一次
+        uint32_t rival = static_cast<uint32_t>(count);
+        Metavision::timestamp rivalKey = kExhausted;
+        for (size_t node = (winner + count) / 2; node > 0; node /= 2) {
+            const uint32_t loser = mTree[node];
+            if (rival == count || before(loser, rival)) {
+                rival = loser;
+                rivalKey = mKeys[loser];
+            }
+        }
+        // 时间戳相同时编号小的源优先，因此胜者编号更大时只能输出严格早于亚军的事件
+        const Metavision::timestamp bound = std::min(limit, winner < rival && rivalKey != kExhausted ? rivalKey + 1 : rivalKey);
+        Source &source = mSources[winner];
+        const int dx = source.offset.dx;
+        const int dy = source.offset.dy;
+        const Metavision::EventCD *head = source.head;
+        const Metavision::EventCD *tail = source.tail;
+        const size_t room = capacity - written;
+        const Metavision::EventCD *stop = head + std::min(room, static_cast<size_t>(tail - head));
+        do {
+            Metavision::EventCD event = *head++;
+            event.x = static_cast<unsigned short>(event.x + dx);
+            event.y = static_cast<unsigned short>(event.y + dy);
+            dst[written++] = event;
+        } while (head != stop && head->t < bound);
+        source.head = head;
+        mKeys[winner] = head != tail ? head->t : kExhausted;
+        replay(winner);
+    }
+    return written;
+}
+
+void EventMerger::emit() {
+    const Metavision::timestamp limit = watermark();
+    while (true) {
+        const size_t written = drain(limit, mBuffer.data(), mBufferSize);
+        if (written == 0) {
+            break;
+        }
+        if (mOutput) {
+            mOutput(mBuffer.data(), mBuffer.data() + written);
+        }
+        if (written < mBufferSize) {
+            break;
+        }
+    }
+    // 已输出完的源释放缓冲区前部
+    for (Source &source : mSources) {
+        if (!source.buffer.empty() && source.head == source.tail) {
+            source.buffer.clear();
+            source.head = source.tail = nullptr;
+        }
+    }
+}
+
+void EventMerger::push(size_t source, const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    Source &target = mSources.at(source);
+    if (target.closed) {
+        throw std::invalid_argument("EventMerger: push to a closed source");
+    }
+    if (begin == end) {
+        return;
+    }
+    if (begin->t < target.watermark) {
+        throw std::invalid_argument("EventMerger: events are earlier than the source watermark");
+    }
+    for (const Metavision::EventCD *event = begin + 1; event != end; ++event) {
+        if (event->t < (event - 1)->t) {
+            throw std::invalid_argument("EventMerger: events must be sorted by timestamp");
+        }
+    }
+    // 未输出的事件移到缓冲区开头，再追加新批次；之后重新指向缓冲区，因为追加可能重新分配
+    const size_t consumed = target.head != nullptr ? static_cast<size_t>(target.head - target.buffer.data()) : 0;
+    target.buffer.erase(target.buffer.begin(), target.buffer.begin() + consumed);
+    target.buffer.insert(target.buffer.end(), begin, end);
+    target.head = target.buffer.data();
+    target.tail = target.buffer.data() + target.buffer.size();
+    target.watermark = (end - 1)->t;
+    // 败者树只能对胜者重赛；源由空变为非空时队首变早，需要重建（O(N)，每批一次）
+    if (mKeys[source] != target.head->t) {
+        rebuild();
+    }
+    emit();
+}
+
+void EventMerger::push(size_t source, const std::vector<Metavision::EventCD> &events) {
+    push(source, events.data(), events.data() + events.size());
+}
+
+void EventMerger::advance(size_t source, Metavision::timestamp watermark) {
+    Source &target = mSources.at(source);
+    if (target.closed || watermark <= target.watermark) {
+        return;
+    }
+    target.watermark = watermark;
+    emit();
+}
+
+void EventMerger::close(size_t source) {
+    Source &target = mSources.at(source);
+    if (target.closed) {
+        return;
+    }
+    target.closed = true;
+    target.watermark = kExhausted;
+    emit();
+}
+
+void EventMerger::finish() {
+    for (Source &source : mSources) {
+        source.closed = true;
+        source.watermark = kExhausted;
+    }
+    emit();
+}
+
+Metavision::timestamp EventMerger::watermark() const noexcept {
+    Metavision::timestamp limit = kExhausted;
+    for (const Source &source : mSources) {
+        limit = std::min(limit, source.watermark);
+    }
+    return limit;
+}
+
+size_t EventMerger::pending() const noexcept {
+    size_t count = 0;
+    for (const Source &source : mSources) {
+        count += static_cast<size_t>(source.tail - source.head);
+    }
+    return count;
+}
+
+void EventMerger::merge(const std::vector<Range> &ranges, std::vector<Metavision::EventCD> &out,
+                        const std::vector<Offset> &offsets) {
+    out.clear();
+    if (ranges.empty()) {
+        return;
+    }
+    if (!offsets.empty() && offsets.size() != ranges.size()) {
+        throw std::invalid_argument("EventMerger: offsets must match ranges");
+    }
+    size_t total = 0;
+    EventMerger merger(ranges.size(), 1);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        Source &source = merger.mSources[i];
+        source.head = ranges[i].begin;
+        source.tail = ranges[i].end;
+        source.closed = true;
+        source.watermark = kExhausted;
+        if (!offsets.empty()) {
+            source.offset = offsets[i];
+        }
+        total += static_cast<size_t>(ranges[i].end - ranges[i].begin);
+    }
+    merger.rebuild();
+    out.resize(total);
+    merger.drain(kExhausted, out.data(), total);
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
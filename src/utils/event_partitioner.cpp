@@ -0,0 +1,136 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_partitioner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+EventPartitioner::EventPartitioner(int height, size_t bands) {
+    if (height <= 0) {
+        throw std::invalid_argument("EventPartitioner: height must be positive");
+    }
+    mBands = std::min<size_t>(std::max<size_t>(bands, 1), static_cast<size_t>(height));
+    mBands = std::min<size_t>(mBands, 65535);
+    mBandRows.resize(mBands + 1);
+    mRowBand.resize(height);
+    for (size_t band = 0; band <= mBands; ++band) {
+        mBandRows[band] = static_cast<int>(band * height / mBands);
+    }
+    for (size_t band = 0; band < mBands; ++band) {
+        for (int y = mBandRows[band]; y < mBandRows[band + 1]; ++y) {
+            mRowBand[y] = static_cast<uint16_t>(band);
+        }
+    }
+    mBandOffsets.assign(mBands + 1, 0);
+}
+
+void EventPartitioner::partition(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                 WorkStealingPool *pool, bool keepIndices) {
+    const size_t count = static_cast<size_t>(end - begin);
+    if (keepIndices && count > UINT32_MAX) {
+        throw std::length_error("EventPartitioner: too many events in one batch");
+    }
+    const size_t chunks = (pool == nullptr) ? 1 : std::max<size_t>(1, std::min(pool->threadCount(), count / 4096));
+    const size_t grain = (count + chunks - 1) / std::max<size_t>(chunks, 1);
+    mChunkCounts.assign(chunks * mBands, 0);
+    mOrdered.resize(count);
+    if (keepIndices) {
+        mIndices.resize(count);
+    }
+
+    auto run = [&](const std::function<void(size_t, size_t)> &body) {
+        if (pool == nullptr || chunks == 1) {
+            body(0, chunks);
+        } else {
+            pool->parallelFor(0, chunks, body, 1);
+        }
+    };
+
+    // 各块统计每个行带的事件数
+    run([&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            size_t *counts = &mChunkCounts[chunk * mBands];
+            const size_t stop = std::min(count, (chunk + 1) * grain);
+            for (size_t i = chunk * grain; i < stop; ++i) {
+                ++counts[mRowBand[begin[i].y]];
+            }
+        }
+    });
+
+    // 前缀和：行带优先、块次之，保证带内保持原始顺序
+    size_t offset = 0;
+    for (size_t band = 0; band < mBands; ++band) {
+        mBandOffsets[band] = offset;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t &slot = mChunkCounts[chunk * mBands + band];
+            const size_t n = slot;
+            slot = offset;
+            offset += n;
+        }
+    }
+    mBandOffsets[mBands] = offset;
+
+    // 各块把事件复制到所在行带的位置
+    run([&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            size_t *offsets = &mChunkCounts[chunk * mBands];
+            const size_t stop = std::min(count, (chunk + 1) * grain);
+            if (keepIndices) {
+                for (size_t i = chunk * grain; i < stop; ++i) {
+                    const size_t slot = offsets[mRowBand[begin[i].y]]++;
+                    mOrdered[slot] = begin[i];
+                    mIndices[slot] = static_cast<uint32_t>(i);
+                }
+            } else {
+                for (size_t i = chunk * grain; i < stop; ++i) {
+                    mOrdered[offsets[mRowBand[begin[i].y]]++] = begin[i];
+                }
+            }
+        }
+    });
+}
+
+void EventPartitioner::forEachBandAlternating(WorkStealingPool *pool, const std::function<void(size_t)> &body) {
+    for (size_t parity = 0; parity < 2; ++parity) {
+        const size_t jobs = (mBands + 1 - parity) / 2;
+        auto run = [&](size_t first, size_t last) {
+            for (size_t job = first; job < last; ++job) {
+                body(2 * job + parity);
+            }
+        };
+        if (pool == nullptr || jobs < 2) {
+            run(0, jobs);
+        } else {
+            pool->parallelFor(0, jobs, run, 1);
+        }
+    }
+}
+
+int EventPartitioner::minBandRows() const noexcept {
+    int rows = mBandRows[1] - mBandRows[0];
+    for (size_t band = 1; band < mBands; ++band) {
+        rows = std::min(rows, mBandRows[band + 1] - mBandRows[band]);
+    }
+    return rows;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
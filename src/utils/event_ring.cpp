@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_ring.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+EventRing::EventRing(size_t slots, size_t slotCapacity) :
+    mSlots(slots),
+    mSlotCapacity(slotCapacity),
+    mTail(0),
+    mHead(0),
+    mClosed(false),
+    mSleeping(false),
+    mPushedBatches(0),
+    mPushedEvents(0),
+    mDroppedBatches(0),
+    mDroppedEvents(0),
+    mHighWaterMark(0)
+{
+    if (slots == 0 || slotCapacity == 0) {
+        throw std::invalid_argument("EventRing: slots and slotCapacity must be positive");
+    }
+    mEvents.resize(slots * slotCapacity);
+    mSizes.assign(slots, 0);
+}
+
+bool EventRing::push(const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+    const size_t count = static_cast<size_t>(end - begin);
+    if (mClosed.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    const size_t head = mHead.load(std::memory_order_acquire);
+    const size_t needed = (count + mSlotCapacity - 1) / mSlotCapacity;
+    if (needed > mSlots - (tail - head)) {
+        // 只丢弃整个批次，消费者不会看到被截断的批次
+        mDroppedBatches.fetch_add(1, std::memory_order_relaxed);
+        mDroppedEvents.fetch_add(count, std::memory_order_relaxed);
+        return false;
+    }
+
+    for (size_t i = 0; i < needed; ++i) {
+        const size_t slot = (tail + i) % mSlots;
+        const size_t offset = i * mSlotCapacity;
+        const size_t size = std::min(mSlotCapacity, count - offset);
+        std::copy(begin + offset, begin + offset + size, mEvents.data() + slot * mSlotCapacity);
+        mSizes[slot] = size;
+    }
+    // 顺序一致的发布与 notify 中对休眠标志的读取配对
+    mTail.store(tail + needed);
+
+    mPushedBatches.fetch_add(1, std::memory_order_relaxed);
+    mPushedEvents.fetch_add(count, std::memory_order_relaxed);
+    if (tail + needed - head > mHighWaterMark.load(std::memory_order_relaxed)) {
+        mHighWaterMark.store(tail + needed - head, std::memory_order_relaxed);
+    }
+    notify();
+    return true;
+}
+
+void EventRing::notify() {
+    // 生产者先发布计数器再读休眠标志，消费者先置休眠标志再读计数器，全部顺序一致，因此不会丢失唤醒
+    if (mSleeping.load()) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWake.notify_one();
+    }
+}
+
+void EventRing::waitForData(std::chrono::microseconds timeout) {
+    // 批次通常很快到达，先自旋一小段时间，避免每批都进入内核
+    for (int spin = 0; spin < 256; ++spin) {
+        if (mHead.load(std::memory_order_relaxed) != mTail.load(std::memory_order_acquire) ||
+            mClosed.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSleeping.store(true);
+    mWake.wait_for(lock, timeout, [this] {
+        return mHead.load(std::memory_order_relaxed) != mTail.load() || mClosed.load();
+    });
+    mSleeping.store(false, std::memory_order_relaxed);
+}
+
+void EventRing::close() {
+    mClosed.store(true);
+    notify();
+}
+
+void EventRing::reset() {
+    mTail.store(0, std::memory_order_relaxed);
+    mHead.store(0, std::memory_order_relaxed);
+    mClosed.store(false, std::memory_order_relaxed);
+    mPushedBatches.store(0, std::memory_order_relaxed);
+    mPushedEvents.store(0, std::memory_order_relaxed);
+    mDroppedBatches.store(0, std::memory_order_relaxed);
+    mDroppedEvents.store(0, std::memory_order_relaxed);
+    mHighWaterMark.store(0, std::memory_order_relaxed);
+    std::fill(mSizes.begin(), mSizes.end(), 0);
+}
+
+EventRing::Stats EventRing::stats() const {
+    return Stats{mPushedBatches.load(std::memory_order_relaxed), mPushedEvents.load(std::memory_order_relaxed),
+                 mDroppedBatches.load(std::memory_order_relaxed), mDroppedEvents.load(std::memory_order_relaxed),
+                 size(), mHighWaterMark.load(std::memory_order_relaxed)};
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
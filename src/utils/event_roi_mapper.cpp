@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/event_roi_mapper.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+EventRoiMapper::EventRoiMapper(int width, int height, const std::vector<Roi> &rois, int binning) :
+    mShift(0),
+    mOutputWidth(0),
+    mOutputHeight(0),
+    mDisjoint(true)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("EventRoiMapper: width and height must be positive");
+    }
+    if (binning != 1 && binning != 2 && binning != 4) {
+        throw std::invalid_argument("EventRoiMapper: binning must be 1, 2 or 4");
+    }
+    mShift = binning == 4 ? 2 : binning - 1;
+
+    std::vector<Roi> regions = rois;
+    if (regions.empty()) {
+        regions.push_back(Roi{0, 0, width, height});
+    }
+    for (const Roi &roi : regions) {
+        if (roi.width <= 0 || roi.height <= 0 || roi.x < 0 || roi.y < 0 || roi.x + roi.width > width ||
+            roi.y + roi.height > height) {
+            throw std::invalid_argument("EventRoiMapper: ROI must be non-empty and inside the sensor");
+        }
+        // 不足一个合并块的边缘按一个块计
+        const int outputWidth = (roi.width + binning - 1) >> mShift;
+        const int outputHeight = (roi.height + binning - 1) >> mShift;
+        mRegions.push_back(Region{roi.x, roi.y, static_cast<uint32_t>(roi.width), static_cast<uint32_t>(roi.height),
+                                  mOutputWidth, outputWidth, outputHeight});
+        mOutputWidth += outputWidth;
+        mOutputHeight = std::max(mOutputHeight, outputHeight);
+    }
+    for (size_t i = 0; i < regions.size(); ++i) {
+        for (size_t j = i + 1; j < regions.size(); ++j) {
+            const Roi &a = regions[i];
+            const Roi &b = regions[j];
+            if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height) {
+                mDisjoint = false;
+            }
+        }
+    }
+}
+
+EventRoiMapper::Roi EventRoiMapper::outputRegion(size_t roi) const {
+    const Region &region = mRegions.at(roi);
+    return Roi{region.outputX, 0, region.outputWidth, region.outputHeight};
+}
+
+void EventRoiMapper::process_events(const Metavision::EventCD *begin, const Metavision::EventCD *end,
+                                    std::vector<Metavision::EventCD> &out) const {
+    const size_t count = static_cast<size_t>(end - begin);
+    // 区域互不重叠时每个事件最多输出一次；无论是否保留都会先写入 dst[kept]，
+    // 最后一个事件落在靠前的区域后，其余区域仍会写到 dst[count]，因此多留 regionCount - 1 个位置
+    if (count == 0) {
+        out.clear();
+        return;
+    }
+    out.resize(mDisjoint ? count + mRegions.size() - 1 : count * mRegions.size());
+    Metavision::EventCD *dst = out.data();
+    const Region *regions = mRegions.data();
+    const size_t regionCount = mRegions.size();
+    const int shift = mShift;
+    size_t kept = 0;
+    for (const Metavision::EventCD *event = begin; event != end; ++event) {
+        for (size_t r = 0; r < regionCount; ++r) {
+            // 坐标在区域左侧或上方时差值回绕成很大的无符号数，一次比较即可判定
+            const uint32_t dx = static_cast<uint32_t>(event->x - regions[r].x);
+            const uint32_t dy = static_cast<uint32_t>(event->y - regions[r].y);
+            const bool inside = (dx < regions[r].width) & (dy < regions[r].height);
+            Metavision::EventCD &mapped = dst[kept];
+            mapped = *event;
+            mapped.x = static_cast<unsigned short>(regions[r].outputX + static_cast<int>(dx >> shift));
+            mapped.y = static_cast<unsigned short>(dy >> shift);
+            kept += inside ? 1 : 0;
+        }
+    }
+    out.resize(kept);
+}
+
+std::vector<Metavision::EventCD> EventRoiMapper::process_events(const std::vector<Metavision::EventCD> &events) const {
+    std::vector<Metavision::EventCD> mapped;
+    process_events(events.data(), events.data() + events.size(), mapped);
+    return mapped;
+}
+
+bool EventRoiMapper::toSensor(int x, int y, int &sensorX, int &sensorY) const noexcept {
+    for (const Region &region : mRegions) {
+        if (x >= region.outputX && x < region.outputX + region.outputWidth && y >= 0 && y < region.outputHeight) {
+            sensorX = region.x + ((x - region.outputX) << mShift);
+            sensorY = region.y + (y << mShift);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/latency_tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+size_t LatencyHistogram::bucketOf(uint64_t value) noexcept {
+    if (value < static_cast<uint64_t>(kLinear)) {
+        return static_cast<size_t>(value);
+    }
+    int exponent = 6;
+    while (exponent < 63 && (value >> (exponent + 1)) != 0) {
+        ++exponent;
+    }
+    if (exponent > kMaxExponent) {
+        return kBuckets - 1;
+    }
+    // 最高位之后的 5 位作为数量级内的子桶
+    const uint64_t sub = (value >> (exponent - 5)) & (kSubBuckets - 1);
+    return kLinear + static_cast<size_t>(exponent - 6) * kSubBuckets + static_cast<size_t>(sub);
+}
+
+int64_t LatencyHistogram::upperBound(size_t bucket) noexcept {
+    if (bucket < static_cast<size_t>(kLinear)) {
+        return static_cast<int64_t>(bucket);
+    }
+    const int exponent = 6 + static_cast<int>((bucket - kLinear) / kSubBuckets);
+    const int64_t sub = static_cast<int64_t>((bucket - kLinear) % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << (exponent - 5)) - 1;
+}
+
+void LatencyHistogram::record(int64_t nanoseconds) noexcept {
+    const uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+    ++mBuckets[bucketOf(value)];
+    ++mCount;
+    mMax = std::max(mMax, static_cast<int64_t>(value));
+}
+
+int64_t LatencyHistogram::percentile(double q) const noexcept {
+    if (mCount == 0) {
+        return 0;
+    }
+    const double clamped = std::min(std::max(q, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(mCount))));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += mBuckets[bucket];
+        if (seen >= rank) {
+            return std::min(upperBound(bucket), mMax);
+        }
+    }
+    return mMax;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) noexcept {
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        mBuckets[bucket] += other.mBuckets[bucket];
+    }
+    mCount += other.mCount;
+    mMax = std::max(mMax, other.mMax);
+}
+
+void LatencyHistogram::reset() noexcept {
+    mBuckets.fill(0);
+    mCount = 0;
+    mMax = 0;
+}
+
+LatencyTracer::LatencyTracer(std::vector<std::string> stages, bool enabled) :
+    mStageNames(std::move(stages)),
+    mEnabled(enabled),
+    mStages(mStageNames.size()),
+    mOffset(0),
+    mHasOffset(false)
+{
+}
+
+LatencyTracer::Trace LatencyTracer::start(Metavision::timestamp sensorTime) {
+    Trace trace;
+    trace.sensorTime = sensorTime;
+    trace.arrival = now();
+    trace.last = trace.arrival;
+    trace.active = true;
+    const int64_t offset = trace.arrival - sensorTime * 1000;
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mHasOffset || offset < mOffset) {
+        mOffset = offset;
+        mHasOffset = true;
+    }
+    return trace;
+}
+
+void LatencyTracer::recordStage(Trace &trace, size_t index) {
+    if (index >= mStages.size()) {
+        throw std::out_of_range("LatencyTracer: stage index out of range");
+    }
+    const int64_t emit = now();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStages[index].record(emit - trace.last);
+    }
+    trace.last = emit;
+}
+
+void LatencyTracer::recordEnd(Trace &trace) {
+    const int64_t emit = now();
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEndToEnd.record(emit - (trace.sensorTime * 1000 + mOffset));
+    trace.active = false;
+}
+
+LatencyTracer::Summary LatencyTracer::summarize(const std::string &name, const LatencyHistogram &histogram) {
+    return Summary{name, histogram.count(), histogram.percentile(0.5) * 1e-3, histogram.percentile(0.99) * 1e-3,
+                   histogram.percentile(0.999) * 1e-3, histogram.max() * 1e-3};
+}
+
+LatencyTracer::Summary LatencyTracer::stageSummary(size_t index) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return summarize(mStageNames.at(index), mStages.at(index));
+}
+
+LatencyTracer::Summary LatencyTracer::endToEndSummary() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return summarize("end_to_end", mEndToEnd);
+}
+
+int64_t LatencyTracer::sensorOffset() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mOffset;
+}
+
+void LatencyTracer::exportCsv(const std::string &path) const {
+    std::vector<Summary> rows;
+    for (size_t i = 0; i < mStageNames.size(); ++i) {
+        rows.push_back(stageSummary(i));
+    }
+    rows.push_back(endToEndSummary());
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to open latency trace file for writing: " + path);
+    }
+    file << "stage,count,p50_us,p99_us,p999_us,max_us\n";
+    for (const Summary &row : rows) {
+        file << row.name << ',' << row.count << ',' << row.p50 << ',' << row.p99 << ',' << row.p999 << ',' << row.max
+             << '\n';
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write latency trace file: " + path);
+    }
+}
+
+void LatencyTracer::reset() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (LatencyHistogram &histogram : mStages) {
+        histogram.reset();
+    }
+    mEndToEnd.reset();
+    mOffset = 0;
+    mHasOffset = false;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/multi_stream_executor.h"
+
+#include <algorithm>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+MultiStreamExecutor::MultiStreamExecutor(size_t threads, size_t quantum) :
+    mQuantum(std::max<size_t>(quantum, 1)),
+    mPool(threads)
+{
+}
+
+MultiStreamExecutor::~MultiStreamExecutor() {
+    flush();
+}
+
+size_t MultiStreamExecutor::addStream(Stage stage, OutputCallback output) {
+    auto stream = std::make_unique<Stream>();
+    stream->id = mStreams.size();
+    stream->stage = std::move(stage);
+    stream->output = std::move(output);
+    mStreams.push_back(std::move(stream));
+    return mStreams.size() - 1;
+}
+
+void MultiStreamExecutor::submit(size_t stream, std::vector<Metavision::EventCD> events) {
+    Stream &target = *mStreams.at(stream);
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        if (target.metrics.submittedBatches == 0) {
+            target.firstSubmit = std::chrono::steady_clock::now();
+        }
+        target.queue.push_back(std::move(events));
+        ++target.metrics.submittedBatches;
+        target.metrics.maxQueueDepth = std::max(target.metrics.maxQueueDepth, target.queue.size());
+        if (!target.scheduled) {
+            target.scheduled = true;
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        mPool.submit([this, &target] { runStream(target); });
+    }
+}
+
+void MultiStreamExecutor::runStream(Stream &stream) {
+    for (size_t processed = 0; processed < mQuantum; ++processed) {
+        std::vector<Metavision::EventCD> batch;
+        {
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            if (stream.queue.empty()) {
+                stream.scheduled = false;
+                return;
+            }
+            batch = std::move(stream.queue.front());
+            stream.queue.pop_front();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<Metavision::EventCD> output = stream.stage(batch);
+        const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const size_t outputSize = output.size();
+        if (stream.output) {
+            stream.output(stream.id, std::move(output));
+        }
+
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        ++stream.metrics.processedBatches;
+        stream.metrics.inputEvents += batch.size();
+        stream.metrics.outputEvents += outputSize;
+        stream.metrics.busyTime += elapsed;
+    }
+
+    // 时间片用完，排到其他流之后继续处理
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        if (stream.queue.empty()) {
+            stream.scheduled = false;
+            return;
+        }
+    }
+    mPool.submit([this, &stream] { runStream(stream); });
+}
+
+void MultiStreamExecutor::flush() {
+    mPool.wait();
+}
+
+MultiStreamExecutor::StreamMetrics MultiStreamExecutor::metrics(size_t stream) const {
+    const Stream &source = *mStreams.at(stream);
+    std::lock_guard<std::mutex> lock(source.mutex);
+    StreamMetrics result = source.metrics;
+    result.queueDepth = source.queue.size();
+    result.processingRate = (result.busyTime > 0) ? result.inputEvents * 1e6 / result.busyTime : 0.0;
+    result.throughput = 0.0;
+    if (result.submittedBatches > 0) {
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - source.firstSubmit).count();
+        result.throughput = (elapsed > 0) ? result.inputEvents / elapsed : 0.0;
+    }
+    return result;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
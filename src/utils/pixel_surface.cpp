@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/pixel_surface.h"
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+namespace {
+constexpr int kTile = 8;
+
+int ceilLog2(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) {
+        ++bits;
+    }
+    return bits;
+}
+
+/// 把 value 的低 bits 位分散到 stride 间隔的位上，从第 first 位开始
+uint32_t spreadBits(uint32_t value, int bits, int first, int stride) {
+    uint32_t result = 0;
+    for (int i = 0; i < bits; ++i) {
+        result |= ((value >> i) & 1U) << (first + i * stride);
+    }
+    return result;
+}
+} // namespace
+
+SurfaceIndex::SurfaceIndex(int width, int height, SurfaceLayout layout) :
+    mLayout(layout),
+    mSize(0)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("SurfaceIndex: width and height must be positive");
+    }
+    mColumn.resize(width);
+    mRow.resize(height);
+    switch (layout) {
+    case SurfaceLayout::Columns:
+        for (int x = 0; x < width; ++x) {
+            mColumn[x] = static_cast<uint32_t>(x) * height;
+        }
+        for (int y = 0; y < height; ++y) {
+            mRow[y] = y;
+        }
+        break;
+    case SurfaceLayout::Rows:
+        for (int x = 0; x < width; ++x) {
+            mColumn[x] = x;
+        }
+        for (int y = 0; y < height; ++y) {
+            mRow[y] = static_cast<uint32_t>(y) * width;
+        }
+        break;
+    case SurfaceLayout::Tiled: {
+        const uint32_t tileRowStride = static_cast<uint32_t>((width + kTile - 1) / kTile) * kTile * kTile;
+        for (int x = 0; x < width; ++x) {
+            mColumn[x] = static_cast<uint32_t>(x / kTile) * kTile * kTile + x % kTile;
+        }
+        for (int y = 0; y < height; ++y) {
+            mRow[y] = static_cast<uint32_t>(y / kTile) * tileRowStride + (y % kTile) * kTile;
+        }
+        break;
+    }
+    case SurfaceLayout::Morton: {
+        // 低位交错（x 在偶数位，y 在奇数位），较长一边多出的高位接在最上面
+        const int xBits = ceilLog2(width);
+        const int yBits = ceilLog2(height);
+        const int shared = std::min(xBits, yBits);
+        if (xBits + yBits > 31) {
+            throw std::invalid_argument("SurfaceIndex: sensor too large for Morton layout");
+        }
+        for (int x = 0; x < width; ++x) {
+            const uint32_t ux = static_cast<uint32_t>(x);
+            mColumn[x] = spreadBits(ux, shared, 0, 2) | ((ux >> shared) << (2 * shared));
+        }
+        for (int y = 0; y < height; ++y) {
+            const uint32_t uy = static_cast<uint32_t>(y);
+            mRow[y] = spreadBits(uy, shared, 1, 2) | ((uy >> shared) << (2 * shared));
+        }
+        break;
+    }
+    default:
+        throw std::invalid_argument("SurfaceIndex: unknown layout");
+    }
+    // 各布局的偏移在 x、y 上都单调递增，最后一个像素的偏移最大
+    mSize = static_cast<size_t>(mColumn[width - 1]) + mRow[height - 1] + 1;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/state_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+namespace {
+constexpr uint32_t kStateMagic = stateTag('H', 'V', 'S', 'T');
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t tag;
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct SectionHeader {
+    uint64_t elementSize;
+    uint64_t count;
+};
+
+constexpr size_t kAlignment = 8;
+
+inline size_t padding(size_t bytes) {
+    return (kAlignment - bytes % kAlignment) % kAlignment;
+}
+} // namespace
+
+StateWriter::StateWriter(const std::string &path, uint32_t tag, uint32_t version) :
+    mFile(path, std::ios::binary | std::ios::trunc),
+    mPath(path)
+{
+    if (!mFile) {
+        throw std::runtime_error("Failed to open state file for writing: " + path);
+    }
+    const FileHeader header{kStateMagic, tag, version, 0};
+    mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void StateWriter::writeSection(const void *data, size_t elementSize, size_t count) {
+    const SectionHeader header{elementSize, count};
+    mFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const size_t bytes = elementSize * count;
+    if (bytes > 0) {
+        mFile.write(static_cast<const char *>(data), bytes);
+    }
+    static const char zeros[kAlignment] = {};
+    mFile.write(zeros, padding(bytes));
+}
+
+void StateWriter::close() {
+    mFile.close();
+    if (!mFile) {
+        throw std::runtime_error("Failed to write state file: " + mPath);
+    }
+}
+
+StateReader::StateReader(const std::string &path, uint32_t tag, uint32_t version) :
+    mPath(path),
+    mData(nullptr),
+    mSize(0),
+    mOffset(sizeof(FileHeader))
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open state file: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Invalid state file: " + path);
+    }
+    mSize = static_cast<size_t>(info.st_size);
+    void *mapped = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to map state file: " + path);
+    }
+    mData = static_cast<const uint8_t *>(mapped);
+
+    FileHeader header;
+    std::memcpy(&header, mData, sizeof(header));
+    if (header.magic != kStateMagic || header.tag != tag || header.version != version) {
+        ::munmap(const_cast<uint8_t *>(mData), mSize);
+        mData = nullptr;
+        throw std::runtime_error("State file does not belong to this filter: " + path);
+    }
+}
+
+StateReader::~StateReader() {
+    if (mData) {
+        ::munmap(const_cast<uint8_t *>(mData), mSize);
+    }
+}
+
+const void *StateReader::next(size_t elementSize, size_t &count) {
+    SectionHeader header;
+    if (mOffset + sizeof(header) > mSize) {
+        throw std::runtime_error("Truncated state file: " + mPath);
+    }
+    std::memcpy(&header, mData + mOffset, sizeof(header));
+    mOffset += sizeof(header);
+    if (header.elementSize != elementSize) {
+        throw std::runtime_error("State element size mismatch: " + mPath);
+    }
+    // 先按剩余字节数限制元素个数再相乘，损坏或恶意的 count 不会让乘积回绕后通过检查
+    if (header.count > (mSize - mOffset) / elementSize) {
+        throw std::runtime_error("Truncated state file: " + mPath);
+    }
+    const size_t bytes = static_cast<size_t>(header.elementSize * header.count);
+    if (mOffset + bytes > mSize) {
+        throw std::runtime_error("Truncated state file: " + mPath);
+    }
+    const void *data = mData + mOffset;
+    mOffset += bytes + padding(bytes);
+    count = static_cast<size_t>(header.count);
+    return data;
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2025 ShiMetaPi
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0 
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "utils/work_stealing_pool.h"
+
+#include <algorithm>
+
+namespace Shimeta {
+namespace Algorithm {
+namespace Utils {
+
+namespace {
+// 当前线程所属的线程池及其队列编号
+thread_local const WorkStealingPool *tCurrentPool = nullptr;
+thread_local size_t tCurrentIndex = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) :
+    mQueued(0),
+    mUnfinished(0),
+    mNextQueue(0),
+    mStop(false)
+{
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        mThreads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (auto &thread : mThreads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    const size_t index = (tCurrentPool == this) ? tCurrentIndex : mNextQueue.fetch_add(1) % mQueues.size();
+    mUnfinished.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(mQueues[index]->mutex);
+        mQueues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mQueued.fetch_add(1);
+    }
+    mWake.notify_one();
+}
+
+bool WorkStealingPool::tryPop(size_t home, Task &task) {
+    {
+        auto &queue = *mQueues[home];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < mQueues.size(); ++offset) {
+        auto &queue = *mQueues[(home + offset) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::execute(Task &task) {
+    task();
+    task = nullptr;
+    if (mUnfinished.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mIdle.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    tCurrentPool = this;
+    tCurrentIndex = index;
+    Task task;
+    while (true) {
+        if (tryPop(index, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWake.wait(lock, [this] { return mStop || mQueued.load() > 0; });
+        if (mStop && mQueued.load() == 0) {
+            return;
+        }
+    }
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(mSleepMutex);
+    mIdle.wait(lock, [this] { return mUnfinished.load() == 0; });
+}
+
+void WorkStealingPool::parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)> &body, size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+        grain = (count + mThreads.size() - 1) / mThreads.size();
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        const size_t chunkBegin = begin + chunk * grain;
+        const size_t chunkEnd = std::min(end, chunkBegin + grain);
+        submit([&body, &remaining, chunkBegin, chunkEnd] {
+            body(chunkBegin, chunkEnd);
+            remaining.fetch_sub(1);
+        });
+    }
+
+    // 调用线程处理第一块，然后协助执行队列中的任务直到全部完成
+    body(begin, std::min(end, begin + grain));
+    remaining.fetch_sub(1);
+    const size_t home = (tCurrentPool == this) ? tCurrentIndex : 0;
+    Task task;
+    while (remaining.load() > 0) {
+        if (tryPop(home, task)) {
+            execute(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace Utils
+} // namespace Algorithm
+} // namespace Shimeta